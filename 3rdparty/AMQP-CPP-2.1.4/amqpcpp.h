@@ -10,17 +10,31 @@
 
 // base C++ include files
 #include <vector>
+#include <algorithm>
 #include <string>
 #include <memory>
+#include <functional>
+#include <new>
 #include <map>
+#include <unordered_map>
 #include <queue>
+#include <deque>
 #include <set>
 #include <limits>
 #include <cstddef>
 #include <cstring>
 #include <stdexcept>
 #include <utility>
+#include <initializer_list>
+#include <type_traits>
 #include <iostream>
+#include <chrono>
+#include <cmath>
+
+// coroutine support, only when the compiler has it
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#include <coroutine>
+#endif
 
 // base C include files
 #include <stdint.h>
@@ -33,10 +47,12 @@
 #include <amqpcpp/endian.h>
 #include <amqpcpp/buffer.h>
 #include <amqpcpp/bytebuffer.h>
+#include <amqpcpp/stringview.h>
 #include <amqpcpp/receivedframe.h>
 #include <amqpcpp/outbuffer.h>
 #include <amqpcpp/watchable.h>
 #include <amqpcpp/monitor.h>
+#include <amqpcpp/bufferpool.h>
 
 // amqp types
 #include <amqpcpp/field.h>
@@ -45,17 +61,26 @@
 #include <amqpcpp/stringfield.h>
 #include <amqpcpp/booleanset.h>
 #include <amqpcpp/fieldproxy.h>
+#include <amqpcpp/fieldvalue.h>
 #include <amqpcpp/table.h>
+#include <amqpcpp/encodedtable.h>
 #include <amqpcpp/array.h>
+#include <amqpcpp/fieldview.h>
+#include <amqpcpp/arrayview.h>
+#include <amqpcpp/tableview.h>
+#include <amqpcpp/numericarray.h>
 
 // envelope for publishing and consuming
 #include <amqpcpp/metadata.h>
 #include <amqpcpp/envelope.h>
 #include <amqpcpp/message.h>
+#include <amqpcpp/messagebatch.h>
+#include <amqpcpp/ownedmessage.h>
 
 // mid level includes
 #include <amqpcpp/exchangetype.h>
 #include <amqpcpp/flags.h>
+#include <amqpcpp/callback.h>
 #include <amqpcpp/callbacks.h>
 #include <amqpcpp/deferred.h>
 #include <amqpcpp/deferredconsumer.h>
@@ -63,6 +88,7 @@
 #include <amqpcpp/deferreddelete.h>
 #include <amqpcpp/deferredcancel.h>
 #include <amqpcpp/deferredget.h>
+#include <amqpcpp/deferredpool.h>
 #include <amqpcpp/channelimpl.h>
 #include <amqpcpp/channel.h>
 #include <amqpcpp/login.h>
@@ -70,3 +96,8 @@
 #include <amqpcpp/connectionimpl.h>
 #include <amqpcpp/connection.h>
 
+// high level utilities
+#include <amqpcpp/qoscontroller.h>
+#include <amqpcpp/dispatcher.h>
+#include <amqpcpp/awaitable.h>
+
@@ -0,0 +1,639 @@
+#pragma once
+/**
+ *  Awaitable.h
+ *
+ *  Support for C++20 coroutines. When the library is used from code that is
+ *  compiled with coroutine support, the deferred objects that are returned by
+ *  the channel can be awaited, instead of installing callbacks on them:
+ *
+ *      AMQP::Task run(AMQP::Channel &channel)
+ *      {
+ *          auto queue = co_await channel.declareQueue(AMQP::exclusive);
+ *          if (!queue) { std::cerr << queue.error << std::endl; co_return; }
+ *
+ *          if (!co_await channel.bindQueue("logs", queue.name, "")) co_return;
+ *
+ *          AMQP::MessageStream stream(channel.consume(queue.name));
+ *          while (auto message = co_await stream.next())
+ *          {
+ *              std::cout << message->bodyView() << std::endl;
+ *              channel.ack(message.deliveryTag());
+ *          }
+ *      }
+ *
+ *  Nothing blocks: the coroutine is suspended until the answer from the server
+ *  comes in, and is resumed from the callback of the deferred object, so it
+ *  runs in the thread of the event loop that calls Connection::parse(). The
+ *  awaiters live in the coroutine frame, and the callbacks that they install
+ *  fit in the callback objects, so awaiting allocates no memory of its own.
+ *  The awaiters remove their callbacks again when the co_await expression is
+ *  done, which is while the deferred object is still reporting its result.
+ *
+ *  Just like callbacks, an awaited operation may never complete, for example
+ *  when the channel is destructed. A suspended coroutine must not be destroyed,
+ *  and callbacks should not be installed on deferred objects that are awaited.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Only available for compilers with coroutine support
+ */
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Return type for coroutines that are started and then run on their own
+ */
+class Task
+{
+public:
+    /**
+     *  The promise of the coroutine
+     */
+    struct promise_type
+    {
+        /**
+         *  The coroutine runs right away, and cleans up itself when it is done
+         */
+        Task get_return_object() noexcept { return Task(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+
+        /**
+         *  There is nobody to report an exception to
+         */
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+/**
+ *  Result of an awaited operation
+ */
+struct DeferredResult
+{
+    /**
+     *  Did the operation fail, and why?
+     *  @var bool
+     */
+    bool failed = false;
+    std::string error;
+
+    /**
+     *  Did the operation succeed?
+     */
+    explicit operator bool () const
+    {
+        return !failed;
+    }
+};
+
+/**
+ *  Result of declaring a queue
+ */
+struct QueueResult : public DeferredResult
+{
+    /**
+     *  Name of the queue, and the number of messages and consumers
+     *  @var std::string
+     */
+    std::string name;
+    uint32_t messageCount = 0;
+    uint32_t consumerCount = 0;
+};
+
+/**
+ *  Result of starting a consumer
+ */
+struct ConsumeResult : public DeferredResult
+{
+    /**
+     *  The consumer tag
+     *  @var std::string
+     */
+    std::string consumerTag;
+};
+
+/**
+ *  Result of getting a message, the message is empty when the queue was empty
+ */
+struct GetResult : public DeferredResult
+{
+    /**
+     *  The message
+     *  @var OwnedMessage
+     */
+    OwnedMessage message;
+};
+
+/**
+ *  Base class of the awaiters
+ */
+template <typename ResultType>
+class Awaiter
+{
+protected:
+    /**
+     *  The result
+     *  @var ResultType
+     */
+    ResultType _result;
+
+    /**
+     *  The suspended coroutine
+     *  @var std::coroutine_handle
+     */
+    std::coroutine_handle<> _handle;
+
+    /**
+     *  Is the operation done?
+     *  @var bool
+     */
+    bool _done = false;
+
+    /**
+     *  Install the callbacks on the deferred object
+     */
+    virtual void install() = 0;
+
+    /**
+     *  Report that the operation is done
+     */
+    void done()
+    {
+        // remember that we are done
+        _done = true;
+
+        // resume the coroutine, unless the callback was called while it was
+        // being suspended (this should be the last thing we do, because the
+        // coroutine may destruct this object)
+        if (_handle) _handle.resume();
+    }
+
+    /**
+     *  Report that the operation failed
+     *  @param  message
+     */
+    void fail(const char *message)
+    {
+        // store the error
+        _result.failed = true;
+        _result.error = message;
+
+        // resume the coroutine
+        done();
+    }
+
+public:
+    /**
+     *  Destructor
+     */
+    virtual ~Awaiter() {}
+
+    /**
+     *  The operation is only started when the coroutine is suspended
+     *  @return bool
+     */
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    /**
+     *  Suspend the coroutine until the operation is done
+     *  @param  handle      the coroutine
+     *  @return bool        false when the operation was already done
+     */
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        // install the callbacks, for operations that fail or that are sent with
+        // the nowait flag they are called right away
+        install();
+
+        // no need to suspend in that case
+        if (_done) return false;
+
+        // resume the coroutine when the answer comes in
+        _handle = handle;
+        return true;
+    }
+
+    /**
+     *  The result for the co_await expression
+     *  @return ResultType
+     */
+    ResultType await_resume()
+    {
+        return std::move(_result);
+    }
+};
+
+/**
+ *  Awaiter for operations that only report success or failure
+ */
+class DeferredAwaiter : public Awaiter<DeferredResult>
+{
+private:
+    /**
+     *  The deferred object
+     *  @var Deferred
+     */
+    Deferred &_deferred;
+
+    /**
+     *  Install the callbacks on the deferred object
+     */
+    virtual void install() override
+    {
+        _deferred.onError([this](const char *message) { fail(message); });
+        _deferred.onSuccess([this]() { done(); });
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  deferred
+     */
+    DeferredAwaiter(Deferred &deferred) : _deferred(deferred) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~DeferredAwaiter()
+    {
+        // the deferred object could call the callbacks again
+        _deferred.onError(nullptr);
+        _deferred.onSuccess(nullptr);
+    }
+};
+
+/**
+ *  Awaiter for declaring a queue
+ */
+class QueueAwaiter : public Awaiter<QueueResult>
+{
+private:
+    /**
+     *  The deferred object
+     *  @var DeferredQueue
+     */
+    DeferredQueue &_deferred;
+
+    /**
+     *  Install the callbacks on the deferred object
+     */
+    virtual void install() override
+    {
+        _deferred.onError([this](const char *message) { fail(message); });
+        _deferred.onSuccess([this](const std::string &name, uint32_t messageCount, uint32_t consumerCount) {
+
+            // store the result
+            _result.name = name;
+            _result.messageCount = messageCount;
+            _result.consumerCount = consumerCount;
+
+            // resume the coroutine
+            done();
+        });
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  deferred
+     */
+    QueueAwaiter(DeferredQueue &deferred) : _deferred(deferred) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~QueueAwaiter()
+    {
+        // the deferred object could call the callbacks again
+        _deferred.onError(nullptr);
+        _deferred.onSuccess(QueueCallback());
+    }
+};
+
+/**
+ *  Awaiter for starting a consumer
+ */
+class ConsumeAwaiter : public Awaiter<ConsumeResult>
+{
+private:
+    /**
+     *  The deferred object
+     *  @var DeferredConsumer
+     */
+    DeferredConsumer &_deferred;
+
+    /**
+     *  Install the callbacks on the deferred object
+     */
+    virtual void install() override
+    {
+        _deferred.onError([this](const char *message) { fail(message); });
+        _deferred.onSuccess([this](const std::string &consumerTag) {
+
+            // store the result
+            _result.consumerTag = consumerTag;
+
+            // resume the coroutine
+            done();
+        });
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  deferred
+     */
+    ConsumeAwaiter(DeferredConsumer &deferred) : _deferred(deferred) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~ConsumeAwaiter()
+    {
+        // the deferred object could call the callbacks again
+        _deferred.onError(nullptr);
+        _deferred.onSuccess(ConsumeCallback());
+    }
+};
+
+/**
+ *  Awaiter for getting a message
+ */
+class GetAwaiter : public Awaiter<GetResult>
+{
+private:
+    /**
+     *  The deferred object
+     *  @var DeferredGet
+     */
+    DeferredGet &_deferred;
+
+    /**
+     *  Install the callbacks on the deferred object
+     */
+    virtual void install() override
+    {
+        _deferred.onError([this](const char *message) { fail(message); });
+        _deferred.onEmpty([this]() { done(); });
+        _deferred.onSuccess([this](const Message &message, uint64_t deliveryTag, bool redelivered) {
+
+            // take the message over, it is only valid during the callback
+            _result.message = OwnedMessage(message, deliveryTag, redelivered);
+
+            // resume the coroutine
+            done();
+        });
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  deferred
+     */
+    GetAwaiter(DeferredGet &deferred) : _deferred(deferred) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~GetAwaiter()
+    {
+        // the deferred object could call the callbacks again
+        _deferred.onError(nullptr);
+        _deferred.onEmpty(nullptr);
+        _deferred.onSuccess(MessageCallback());
+    }
+};
+
+/**
+ *  Make the deferred objects awaitable
+ *  @param  deferred
+ *  @return Awaiter
+ */
+inline DeferredAwaiter operator co_await(Deferred &deferred) { return DeferredAwaiter(deferred); }
+inline QueueAwaiter operator co_await(DeferredQueue &deferred) { return QueueAwaiter(deferred); }
+inline ConsumeAwaiter operator co_await(DeferredConsumer &deferred) { return ConsumeAwaiter(deferred); }
+inline GetAwaiter operator co_await(DeferredGet &deferred) { return GetAwaiter(deferred); }
+
+/**
+ *  The messages of a consumer, one by one
+ *
+ *  Messages that come in while nobody awaits them are kept in the stream. The
+ *  stream ends when the consumer fails, or when close() is called, for example
+ *  after the consumer was cancelled. Cancel the consumer before the stream is
+ *  destructed, messages that come in afterwards are not acked or rejected.
+ */
+class MessageStream : public Watchable
+{
+private:
+    /**
+     *  Messages that were not yet awaited
+     *  @var std::deque<OwnedMessage>
+     */
+    std::deque<OwnedMessage> _messages;
+
+    /**
+     *  The coroutine that awaits the next message
+     *  @var std::coroutine_handle
+     */
+    std::coroutine_handle<> _handle;
+
+    /**
+     *  Has the stream ended, and why?
+     *  @var bool
+     */
+    bool _closed = false;
+    std::string _error;
+
+    /**
+     *  Resume the coroutine that awaits the next message
+     */
+    void wake()
+    {
+        // leap out if nobody is waiting
+        if (!_handle) return;
+
+        // the coroutine no longer waits (this object could be destructed
+        // when it is resumed, so we take the handle first)
+        auto handle = _handle;
+        _handle = nullptr;
+
+        // resume it
+        handle.resume();
+    }
+
+public:
+    /**
+     *  Awaiter for the next message
+     */
+    class Next
+    {
+    private:
+        /**
+         *  The stream
+         *  @var MessageStream
+         */
+        MessageStream &_stream;
+
+    public:
+        /**
+         *  Constructor
+         *  @param  stream
+         */
+        Next(MessageStream &stream) : _stream(stream) {}
+
+        /**
+         *  Is there a message, or has the stream ended?
+         *  @return bool
+         */
+        bool await_ready() const noexcept
+        {
+            return !_stream._messages.empty() || _stream._closed;
+        }
+
+        /**
+         *  Wait for a message
+         *  @param  handle      the coroutine
+         */
+        void await_suspend(std::coroutine_handle<> handle) noexcept
+        {
+            _stream._handle = handle;
+        }
+
+        /**
+         *  The message, an empty object when the stream has ended
+         *  @return OwnedMessage
+         */
+        OwnedMessage await_resume()
+        {
+            // the stream has ended
+            if (_stream._messages.empty()) return OwnedMessage();
+
+            // take the oldest message
+            OwnedMessage result(std::move(_stream._messages.front()));
+            _stream._messages.pop_front();
+
+            // done
+            return result;
+        }
+    };
+
+    /**
+     *  Constructor
+     *
+     *  This installs the onReceived() and onError() callbacks of the consumer.
+     *
+     *  @param  consumer    the deferred object returned by Channel::consume()
+     */
+    MessageStream(DeferredConsumer &consumer)
+    {
+        // the stream could be destructed before the consumer
+        auto monitor = std::make_shared<Monitor>(this);
+
+        // keep the messages
+        consumer.onReceived([this, monitor](const Message &message, uint64_t deliveryTag, bool redelivered) {
+
+            // leap out if the stream no longer exists
+            if (!monitor->valid()) return;
+
+            // take the message over
+            OwnedMessage owned(message, deliveryTag, redelivered);
+            if (owned) _messages.push_back(std::move(owned));
+
+            // pass it to the coroutine that waits for it
+            wake();
+        });
+
+        // the stream ends when the consumer fails
+        consumer.onError([this, monitor](const char *message) {
+
+            // leap out if the stream no longer exists
+            if (!monitor->valid()) return;
+
+            // remember why
+            _error = message;
+
+            // end the stream
+            close();
+        });
+    }
+
+    /**
+     *  The stream can not be copied
+     *  @param  that
+     */
+    MessageStream(const MessageStream &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~MessageStream() {}
+
+    /**
+     *  Await the next message
+     *
+     *  The result is an empty OwnedMessage when the stream has ended, after
+     *  the messages that were already received.
+     *
+     *  @return Next
+     */
+    Next next()
+    {
+        return Next(*this);
+    }
+
+    /**
+     *  End the stream, a coroutine that awaits the next message is resumed
+     */
+    void close()
+    {
+        // remember that we are done
+        _closed = true;
+
+        // resume the coroutine
+        wake();
+    }
+
+    /**
+     *  Has the stream ended?
+     *  @return bool
+     */
+    bool closed() const
+    {
+        return _closed;
+    }
+
+    /**
+     *  Why the stream ended, empty when it was closed
+     *  @return std::string
+     */
+    const std::string &error() const
+    {
+        return _error;
+    }
+
+    /**
+     *  Number of messages that were not yet awaited
+     *  @return size_t
+     */
+    size_t size() const
+    {
+        return _messages.size();
+    }
+};
+
+/**
+ *  End namespace
+ */
+}
+
+#endif
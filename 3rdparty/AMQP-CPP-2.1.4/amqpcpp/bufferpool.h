@@ -0,0 +1,152 @@
+#pragma once
+/**
+ *  BufferPool.h
+ *
+ *  Pool of buffers that are used to reassemble message bodies that span
+ *  multiple frames. Every connection has its own pool. The buffers are
+ *  grouped in size classes (powers of two), so that a buffer that was used
+ *  for one message can be reused for any other message of about the same
+ *  size, without going to the heap for every message.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class BufferPool
+{
+private:
+    /**
+     *  Size of the smallest and the largest size class, as a power of two,
+     *  bigger buffers are not pooled
+     */
+    static const int smallest = 12;
+    static const int largest = 24;
+
+    /**
+     *  The free buffers, per size class
+     *  @var std::vector<char*>
+     */
+    std::vector<char*> _free[largest - smallest + 1];
+
+    /**
+     *  Maximum number of bytes in free buffers
+     *  @var uint64_t
+     */
+    uint64_t _limit;
+
+    /**
+     *  Number of bytes in free buffers
+     *  @var uint64_t
+     */
+    uint64_t _pooled = 0;
+
+    /**
+     *  Number of buffers that came from the pool, and that had to be allocated
+     *  @var uint64_t
+     */
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+
+    /**
+     *  The size class for a buffer size, or -1 if buffers of this size are not pooled
+     *  @param  size
+     *  @return int
+     */
+    static int index(uint64_t size);
+
+    /**
+     *  Drop free buffers until we are within the limit
+     */
+    void trim();
+
+public:
+    /**
+     *  Constructor
+     *  @param  limit       maximum number of bytes to keep in free buffers
+     */
+    BufferPool(uint64_t limit = 64 * 1024 * 1024) : _limit(limit) {}
+
+    /**
+     *  The pool can not be copied
+     *  @param  that
+     */
+    BufferPool(const BufferPool &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~BufferPool();
+
+    /**
+     *  Get a buffer
+     *  @param  size        number of bytes that are needed
+     *  @param  capacity    set to the actual size of the buffer
+     *  @return char*
+     */
+    char *allocate(uint64_t size, uint64_t &capacity);
+
+    /**
+     *  Give a buffer back to the pool
+     *  @param  buffer      buffer that was returned by allocate()
+     *  @param  capacity    the capacity of the buffer
+     */
+    void release(char *buffer, uint64_t capacity);
+
+    /**
+     *  Change the maximum number of bytes to keep in free buffers
+     *  @param  limit
+     */
+    void setLimit(uint64_t limit)
+    {
+        _limit = limit;
+        trim();
+    }
+
+    /**
+     *  Maximum number of bytes to keep in free buffers
+     *  @return uint64_t
+     */
+    uint64_t limit() const
+    {
+        return _limit;
+    }
+
+    /**
+     *  Number of bytes in free buffers
+     *  @return uint64_t
+     */
+    uint64_t pooled() const
+    {
+        return _pooled;
+    }
+
+    /**
+     *  Number of buffers that were taken from the pool
+     *  @return uint64_t
+     */
+    uint64_t hits() const
+    {
+        return _hits;
+    }
+
+    /**
+     *  Number of buffers that had to be allocated
+     *  @return uint64_t
+     */
+    uint64_t misses() const
+    {
+        return _misses;
+    }
+};
+
+/**
+ *  End namespace
+ */
+}
@@ -0,0 +1,342 @@
+#pragma once
+/**
+ *  Callback.h
+ *
+ *  Function wrapper that is used for all callbacks. It works like a
+ *  std::function, but has a bigger inline buffer, so that the lambdas that
+ *  are normally passed to the library (capturing a couple of pointers and
+ *  references) are stored without a heap allocation of their own.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class declaration, only function signatures are specialized
+ */
+template <typename Signature>
+class Callback;
+
+/**
+ *  Class definition
+ */
+template <typename R, typename... Args>
+class Callback<R(Args...)>
+{
+private:
+    /**
+     *  Base class for the stored function
+     */
+    class Callable
+    {
+    public:
+        /**
+         *  Destructor
+         */
+        virtual ~Callable() {}
+
+        /**
+         *  Call the function
+         *  @param  args
+         *  @return R
+         */
+        virtual R invoke(Args... args) = 0;
+
+        /**
+         *  Create a copy in a buffer, or on the heap if it does not fit
+         *  @param  buffer
+         *  @param  size
+         *  @return Callable
+         */
+        virtual Callable *copy(void *buffer, size_t size) const = 0;
+
+        /**
+         *  Move into a buffer, or to the heap if it does not fit
+         *  @param  buffer
+         *  @param  size
+         *  @return Callable
+         */
+        virtual Callable *move(void *buffer, size_t size) = 0;
+    };
+
+    /**
+     *  Implementation for a specific function type
+     */
+    template <typename F>
+    class Implementation : public Callable
+    {
+    private:
+        /**
+         *  The function
+         *  @var F
+         */
+        F _function;
+
+    public:
+        /**
+         *  Constructor
+         *  @param  function
+         */
+        Implementation(const F &function) : _function(function) {}
+        Implementation(F &&function) : _function(std::move(function)) {}
+
+        /**
+         *  Destructor
+         */
+        virtual ~Implementation() {}
+
+        /**
+         *  Call the function
+         *  @param  args
+         *  @return R
+         */
+        virtual R invoke(Args... args) override
+        {
+            return static_cast<R>(_function(std::forward<Args>(args)...));
+        }
+
+        /**
+         *  Create a copy in a buffer, or on the heap if it does not fit
+         *  @param  buffer
+         *  @param  size
+         *  @return Callable
+         */
+        virtual Callable *copy(void *buffer, size_t size) const override
+        {
+            if (fits(size)) return new (buffer) Implementation(_function);
+            return new Implementation(_function);
+        }
+
+        /**
+         *  Move into a buffer, or to the heap if it does not fit
+         *  @param  buffer
+         *  @param  size
+         *  @return Callable
+         */
+        virtual Callable *move(void *buffer, size_t size) override
+        {
+            if (fits(size)) return new (buffer) Implementation(std::move(_function));
+            return new Implementation(std::move(_function));
+        }
+
+        /**
+         *  Does the implementation fit in a buffer? Functions that could throw
+         *  when they are moved are always stored on the heap, so that moving a
+         *  callback never throws
+         *  @param  size
+         *  @return bool
+         */
+        static constexpr bool fits(size_t size)
+        {
+            return sizeof(Implementation) <= size && alignof(Implementation) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible<F>::value;
+        }
+    };
+
+    /**
+     *  Helper to check whether a type can be stored, it should be callable with
+     *  the right arguments (so that overloads for different callbacks work),
+     *  and it should not be a callback or std::function itself
+     */
+    template <typename F, typename = void>
+    struct accepts : std::false_type {};
+
+    template <typename F>
+    struct accepts<F, typename std::enable_if<std::is_void<R>::value || std::is_convertible<decltype(std::declval<typename std::decay<F>::type&>()(std::declval<Args>()...)), R>::value>::type>
+        : std::integral_constant<bool, !std::is_same<typename std::decay<F>::type, Callback>::value && !std::is_same<typename std::decay<F>::type, std::function<R(Args...)>>::value> {};
+
+    /**
+     *  Inline storage, big enough for a lambda with a couple of captures
+     *  @var char[]
+     */
+    alignas(std::max_align_t) char _buffer[6 * sizeof(void *)];
+
+    /**
+     *  The stored function, this points to the buffer when it fitted in it
+     *  @var Callable
+     */
+    Callable *_callable = nullptr;
+
+    /**
+     *  Is the function stored inside the buffer?
+     *  @return bool
+     */
+    bool local() const
+    {
+        return (const void *)_callable == (const void *)_buffer;
+    }
+
+    /**
+     *  Destruct the current function
+     */
+    void clear()
+    {
+        // functions in the buffer are only destructed, others are deallocated too
+        if (local()) _callable->~Callable();
+        else delete _callable;
+
+        // forget the function
+        _callable = nullptr;
+    }
+
+    /**
+     *  Store a function
+     *  @param  function
+     */
+    template <typename F>
+    void construct(F &&function)
+    {
+        // the type that is stored
+        typedef Implementation<typename std::decay<F>::type> Type;
+
+        // construct in the buffer if it fits
+        if (Type::fits(sizeof(_buffer))) _callable = new (_buffer) Type(std::forward<F>(function));
+        else _callable = new Type(std::forward<F>(function));
+    }
+
+    /**
+     *  Take over the function of a different callback
+     *  @param  that
+     */
+    void take(Callback &&that)
+    {
+        // nothing to take over
+        if (!that._callable) return;
+
+        // functions on the heap are swapped, the others are moved into our buffer
+        if (!that.local()) std::swap(_callable, that._callable);
+        else _callable = that._callable->move(_buffer, sizeof(_buffer));
+    }
+
+public:
+    /**
+     *  Constructor for an empty callback
+     */
+    Callback() {}
+    Callback(std::nullptr_t) {}
+
+    /**
+     *  Constructor from a function, lambda or function object
+     *  @param  function
+     */
+    template <typename F, typename = typename std::enable_if<accepts<F>::value>::type>
+    Callback(F &&function)
+    {
+        construct(std::forward<F>(function));
+    }
+
+    /**
+     *  Constructor from a std::function, which could be empty
+     *  @param  function
+     */
+    Callback(const std::function<R(Args...)> &function)
+    {
+        // only store functions that can be called
+        if (function) construct(function);
+    }
+
+    /**
+     *  Copy constructor
+     *  @param  that
+     */
+    Callback(const Callback &that) : _callable(that._callable ? that._callable->copy(_buffer, sizeof(_buffer)) : nullptr) {}
+
+    /**
+     *  Move constructor
+     *  @param  that
+     */
+    Callback(Callback &&that)
+    {
+        take(std::move(that));
+    }
+
+    /**
+     *  Destructor
+     */
+    ~Callback()
+    {
+        if (_callable) clear();
+    }
+
+    /**
+     *  Assign a different callback
+     *  @param  that
+     *  @return Callback
+     */
+    Callback &operator=(const Callback &that)
+    {
+        // skip self assignment
+        if (this == &that) return *this;
+
+        // copy first, the other callback could be owned by our own function
+        Callback copy(that);
+
+        // and move the copy in place
+        return operator=(std::move(copy));
+    }
+
+    /**
+     *  Move a different callback
+     *  @param  that
+     *  @return Callback
+     */
+    Callback &operator=(Callback &&that)
+    {
+        // skip self assignment
+        if (this == &that) return *this;
+
+        // forget the current function
+        if (_callable) clear();
+
+        // take over the other one
+        take(std::move(that));
+
+        // allow chaining
+        return *this;
+    }
+
+    /**
+     *  Remove the function
+     *  @return Callback
+     */
+    Callback &operator=(std::nullptr_t)
+    {
+        // forget the current function
+        if (_callable) clear();
+
+        // allow chaining
+        return *this;
+    }
+
+    /**
+     *  Is a function stored?
+     *  @return bool
+     */
+    explicit operator bool () const
+    {
+        return _callable != nullptr;
+    }
+
+    /**
+     *  Call the function
+     *  @param  args
+     *  @return R
+     */
+    R operator()(Args... args) const
+    {
+        // calling an empty callback is an error, just like it is for std::function
+        if (!_callable) throw std::bad_function_call();
+
+        // call the function
+        return _callable->invoke(std::forward<Args>(args)...);
+    }
+
+};
+
+/**
+ *  End namespace
+ */
+}
@@ -15,18 +15,26 @@ namespace AMQP {
  *  All the callbacks that are supported
  * 
  *  When someone registers a callback function for certain events, it should
- *  match one of the following signatures.
+ *  match one of the following signatures. Lambdas with a few captures are
+ *  stored without allocating memory, see callback.h.
  */
-using SuccessCallback   =   std::function<void()>;
-using ErrorCallback     =   std::function<void(const char *message)>;
-using FinalizeCallback  =   std::function<void()>;
-using EmptyCallback     =   std::function<void()>;
-using MessageCallback   =   std::function<void(const Message &message, uint64_t deliveryTag, bool redelivered)>;
-using QueueCallback     =   std::function<void(const std::string &name, uint32_t messagecount, uint32_t consumercount)>;
-using DeleteCallback    =   std::function<void(uint32_t deletedmessages)>;
-using SizeCallback      =   std::function<void(uint32_t messagecount)>;
-using ConsumeCallback   =   std::function<void(const std::string &consumer)>;
-using CancelCallback    =   std::function<void(const std::string &consumer)>;
+using SuccessCallback   =   Callback<void()>;
+using ErrorCallback     =   Callback<void(const char *message)>;
+using FinalizeCallback  =   Callback<void()>;
+using EmptyCallback     =   Callback<void()>;
+using MessageCallback   =   Callback<void(const Message &message, uint64_t deliveryTag, bool redelivered)>;
+using BatchCallback     =   Callback<void(const MessageBatch &batch)>;
+using ChunkCallback     =   Callback<void(const char *data, size_t size)>;
+using CompleteCallback  =   Callback<void(uint64_t deliveryTag, bool redelivered)>;
+using ReadCallback      =   Callback<size_t(char *buffer, size_t size)>;
+using QueueCallback     =   Callback<void(const std::string &name, uint32_t messagecount, uint32_t consumercount)>;
+using DeleteCallback    =   Callback<void(uint32_t deletedmessages)>;
+using SizeCallback      =   Callback<void(uint32_t messagecount)>;
+using ConsumeCallback   =   Callback<void(const std::string &consumer)>;
+using CancelCallback    =   Callback<void(const std::string &consumer)>;
+using FlowCallback      =   Callback<void(bool active)>;
+using KeyCallback       =   Callback<StringView(const Message &message)>;
+using AckCallback       =   Callback<bool(uint64_t deliveryTag, int flags)>;
 
 /**
  *  End namespace
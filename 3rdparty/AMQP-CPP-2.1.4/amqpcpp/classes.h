@@ -15,6 +15,7 @@ namespace AMQP {
  *  All classes defined by this library
  */
 class Array;
+class ArrayView;
 class BasicDeliverFrame;
 class BasicGetOKFrame;
 class BasicHeaderFrame;
@@ -27,11 +28,13 @@ class ConnectionImpl;
 class Exchange;
 class Frame;
 class Login;
+class MessageBatch;
 class MessageImpl;
 class Monitor;
 class OutBuffer;
 class ReceivedFrame;
 class Table;
+class TableView;
 
 /**
  *  End of namespace
@@ -134,6 +134,44 @@ public:
         return _implementation.parse(buffer);
     }
 
+    /**
+     *  Send the next part of the bodies of streaming publishes
+     *
+     *  Messages that are published with a read callback are not sent all at
+     *  once. Their body is read and sent frame by frame when you call this
+     *  method, which you should do when your output buffer has room for more
+     *  data. Nothing is sent while the server has blocked the connection.
+     *
+     *  @param  max         number of bytes to send (at least one frame is sent)
+     *  @return size_t      number of bytes sent, zero if there is nothing to send
+     */
+    size_t pump(size_t max)
+    {
+        return _implementation.pump(max);
+    }
+
+    /**
+     *  Is the connection blocked by the server? This happens when the server
+     *  runs low on resources, publishing is not possible until it is unblocked.
+     *  @return bool
+     */
+    bool blocked() const
+    {
+        return _implementation.blocked();
+    }
+
+    /**
+     *  The pool that holds the buffers in which message bodies that span
+     *  multiple frames are reassembled. You can use it to change how much
+     *  memory is kept for reuse, and to see how often a buffer could be
+     *  reused (hits) or had to be allocated (misses).
+     *  @return BufferPool
+     */
+    BufferPool &pool()
+    {
+        return *_implementation.pool();
+    }
+
     /**
      *  Close the connection
      *  This will close all channels
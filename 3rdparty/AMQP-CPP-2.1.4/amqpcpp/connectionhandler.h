@@ -76,6 +76,28 @@ public:
      */
     virtual void onClosed(Connection *connection) {}
 
+    /**
+     *  Method that is called when the server blocks the connection.
+     *
+     *  The server does this when it runs low on resources, like memory or
+     *  disk space. It then stops reading from connections that publish, so
+     *  everything that is sent now only fills up the output buffers. While
+     *  the connection is blocked, Channel::publish() fails right away, so
+     *  that the publisher can drop or spool its messages instead.
+     *
+     *  @param  connection      The connection that is blocked
+     *  @param  reason          Why the connection is blocked
+     */
+    virtual void onBlocked(Connection *connection, const char *reason) {}
+
+    /**
+     *  Method that is called when the server unblocks the connection, and
+     *  messages can be published again.
+     *
+     *  @param  connection      The connection that is no longer blocked
+     */
+    virtual void onUnblocked(Connection *connection) {}
+
 };
 
 /**
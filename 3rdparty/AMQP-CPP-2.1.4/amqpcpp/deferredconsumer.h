@@ -35,6 +35,34 @@ private:
      */
     MessageCallback _messageCallback;
 
+    /**
+     *  Callback for batches of incoming messages
+     *  @var    BatchCallback
+     */
+    BatchCallback _batchCallback;
+
+    /**
+     *  The consumer tag, only set when the consumer was started with the nowait option
+     *  @var    std::string
+     */
+    std::string _tag;
+
+    /**
+     *  Callbacks for streaming consumers
+     *  @var    MessageCallback
+     *  @var    ChunkCallback
+     *  @var    CompleteCallback
+     */
+    MessageCallback _headersCallback;
+    ChunkCallback _chunkCallback;
+    CompleteCallback _completeCallback;
+
+    /**
+     *  Install the callbacks on the channel, this is done when the consumer
+     *  is started, or right away for consumers with the nowait option
+     *  @param  tag             Consumer tag
+     */
+    void install(const std::string &tag) const;
 
     /**
      *  Report success for frames that report start consumer operations
@@ -74,6 +102,9 @@ public:
     {
         // store the callback
         _consumeCallback = callback;
+
+        // if the server does not answer, we call the callback right away
+        if (_nowait && !_failed && callback) callback(_tag);
         
         // allow chaining
         return *this;
@@ -101,6 +132,9 @@ public:
     {
         // store callback
         _messageCallback = callback;
+
+        // if the server does not answer, the consumer is already running
+        if (_nowait && !_failed) install(_tag);
         
         // allow chaining
         return *this;
@@ -115,10 +149,95 @@ public:
     {
         // store callback
         _messageCallback = callback;
+
+        // if the server does not answer, the consumer is already running
+        if (_nowait && !_failed) install(_tag);
         
         // allow chaining
         return *this;
     }
+
+    /**
+     *  Register a function to be called with all messages for this consumer
+     *  that were decoded by a single call to Connection::parse()
+     *
+     *  The batch is passed when the parse() call has processed all data, or
+     *  earlier when something else happens on the channel. If a batch callback
+     *  is installed, the onReceived() callback is not called.
+     *
+     *  @param  callback    the callback to execute
+     */
+    DeferredConsumer &onReceivedBatch(const BatchCallback &callback)
+    {
+        // store callback
+        _batchCallback = callback;
+
+        // if the server does not answer, the consumer is already running
+        if (_nowait && !_failed) install(_tag);
+
+        // allow chaining
+        return *this;
+    }
+
+    /**
+     *  Register a function to be called when the headers of a message arrive
+     *
+     *  Installing one of the onHeaders(), onBodyChunk() or onComplete() callbacks
+     *  turns the consumer into a streaming consumer. Its messages are not stored
+     *  in memory, but the body is passed to onBodyChunk() frame by frame, so that
+     *  big messages can be written to disk or hashed with constant memory. The
+     *  onReceived() and onReceivedBatch() callbacks are then not called.
+     *
+     *  The message that is passed to this callback holds all meta data, and the
+     *  full size of the body, but not the body itself: body() returns nullptr.
+     *
+     *  @param  callback    the callback to execute
+     */
+    DeferredConsumer &onHeaders(const MessageCallback &callback)
+    {
+        // store callback
+        _headersCallback = callback;
+
+        // if the server does not answer, the consumer is already running
+        if (_nowait && !_failed) install(_tag);
+
+        // allow chaining
+        return *this;
+    }
+
+    /**
+     *  Register a function to be called for every part of the body of a message
+     *  that arrives, the data is only valid during the call (see onHeaders())
+     *  @param  callback    the callback to execute
+     */
+    DeferredConsumer &onBodyChunk(const ChunkCallback &callback)
+    {
+        // store callback
+        _chunkCallback = callback;
+
+        // if the server does not answer, the consumer is already running
+        if (_nowait && !_failed) install(_tag);
+
+        // allow chaining
+        return *this;
+    }
+
+    /**
+     *  Register a function to be called when the full body of a message has
+     *  been passed to onBodyChunk(), it gets the delivery tag to ack the message
+     *  @param  callback    the callback to execute
+     */
+    DeferredConsumer &onComplete(const CompleteCallback &callback)
+    {
+        // store callback
+        _completeCallback = callback;
+
+        // if the server does not answer, the consumer is already running
+        if (_nowait && !_failed) install(_tag);
+
+        // allow chaining
+        return *this;
+    }
 };
 
 /**
@@ -0,0 +1,281 @@
+#pragma once
+/**
+ *  Dispatcher.h
+ *
+ *  Class that runs the handler of a consumer in worker threads, while keeping
+ *  the messages with the same key in order.
+ *
+ *  Consumer callbacks normally run in the thread that calls Connection::parse(),
+ *  so a slow handler stalls all channels of the connection. The dispatcher
+ *  takes the messages over (see OwnedMessage) and passes them to a number of
+ *  worker threads, called lanes. The lane is chosen by a hash of a key of the
+ *  message, like the routing key, so all messages with the same key are
+ *  handled by the same thread, in the order in which they arrived, while
+ *  messages with other keys are handled in parallel.
+ *
+ *  When the handler returns, the message is acknowledged. The acks are passed
+ *  back to the thread of the connection, which sends them when it calls
+ *  flush(). Messages that are done in the order of arrival are acked together,
+ *  with a single ack with the multiple flag.
+ *
+ *      AMQP::Dispatcher dispatcher(&channel, 4, AMQP::Dispatcher::routingKey, [](const AMQP::Message &message, uint64_t deliveryTag, bool redelivered) {
+ *
+ *          // handle the message, this runs in a worker thread
+ *      });
+ *
+ *      channel.consume("queue").onReceived([&dispatcher](const AMQP::Message &message, uint64_t deliveryTag, bool redelivered) {
+ *          dispatcher.dispatch(message, deliveryTag, redelivered);
+ *      });
+ *
+ *      // and in the event loop, every now and then
+ *      dispatcher.flush();
+ *
+ *  Without a key callback, the messages are spread over the lanes one by one.
+ *  The thread of the connection then only parses the input and passes on
+ *  complete messages, so it keeps up with the network even when handling a
+ *  message takes long, but messages are no longer handled in order.
+ *
+ *  The handler can publish messages, for example the answer to an RPC call,
+ *  with the publish() method of the dispatcher. These messages are passed
+ *  back to the thread of the connection together with the acks, and are
+ *  published before the message that was handled is acked.
+ *
+ *  When the handler throws an exception, the message is rejected instead of
+ *  acked. It is not requeued, because it would probably fail again, so the
+ *  server drops it, or passes it to the dead letter exchange of the queue.
+ *
+ *  The acks and rejects are sent with the channel, unless callbacks were
+ *  installed with onAck() and onReject(), for example to pass them on to a
+ *  QosController.
+ *
+ *  All other methods should be called from the thread of the connection, only
+ *  the handler runs in the worker threads.
+ *
+ *  Because of the multiple flag, an ack also covers earlier messages on the
+ *  same channel. So use a channel of its own for the consumer(s) whose
+ *  messages are dispatched, and do not consume with the noack flag.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Forward declarations
+ */
+class DispatcherLane;
+
+/**
+ *  Class definition
+ */
+class Dispatcher : public Watchable
+{
+private:
+    /**
+     *  The channel that consumes the messages
+     *  @var Channel
+     */
+    Channel *_channel;
+
+    /**
+     *  Callback that gives the key of a message
+     *  @var KeyCallback
+     */
+    KeyCallback _key;
+
+    /**
+     *  The handler that runs in the worker threads
+     *  @var MessageCallback
+     */
+    MessageCallback _handler;
+
+    /**
+     *  Callbacks that send acks and rejects instead of the channel
+     *  @var AckCallback
+     */
+    AckCallback _ack;
+    AckCallback _reject;
+
+    /**
+     *  The lanes
+     *  @var std::vector
+     */
+    std::vector<std::unique_ptr<DispatcherLane>> _lanes;
+
+    /**
+     *  Delivery tags of the messages that were dispatched but not yet acked,
+     *  in the order of arrival
+     *  @var std::deque<uint64_t>
+     */
+    std::deque<uint64_t> _outstanding;
+
+    /**
+     *  Messages that were handled, but that were not yet removed from the
+     *  outstanding messages, because an earlier message is still busy
+     *  @var std::set<uint64_t>
+     */
+    std::set<uint64_t> _finished;
+
+    /**
+     *  Messages from the set above that were already acked on their own
+     *  @var std::set<uint64_t>
+     */
+    std::set<uint64_t> _acked;
+
+    /**
+     *  The lane for the next message, when there is no key callback
+     *  @var size_t
+     */
+    size_t _next = 0;
+
+    /**
+     *  Take the handled and published messages from a lane
+     *  @param  lane
+     *  @return size_t      number of handled messages
+     */
+    size_t collect(DispatcherLane *lane);
+
+    /**
+     *  Send an ack or a reject, via the callback or the channel
+     *  @param  deliveryTag
+     *  @param  flags
+     *  @return bool
+     */
+    bool ack(uint64_t deliveryTag, int flags = 0);
+    bool reject(uint64_t deliveryTag, int flags = 0);
+
+public:
+    /**
+     *  Constructor
+     *
+     *  The key callback runs in the thread of the connection, the handler
+     *  runs in the worker threads. Pass nullptr as key callback to spread the
+     *  messages over the threads one by one, without keeping them in order.
+     *
+     *  @param  channel     the channel that consumes the messages
+     *  @param  lanes       number of worker threads
+     *  @param  key         callback that gives the key of a message
+     *  @param  handler     callback that handles a message
+     *  @param  capacity    number of messages that can be passed to a lane at once
+     */
+    Dispatcher(Channel *channel, size_t lanes, const KeyCallback &key, const MessageCallback &handler, size_t capacity = 1024);
+
+    /**
+     *  The dispatcher can not be copied
+     *  @param  that
+     */
+    Dispatcher(const Dispatcher &that) = delete;
+
+    /**
+     *  Destructor
+     *
+     *  This waits until the workers are done with the message that they are
+     *  handling, and acks the messages that were handled. Messages that were
+     *  dispatched but not yet handled are not acked, the server delivers them
+     *  again when the channel is closed.
+     */
+    virtual ~Dispatcher();
+
+    /**
+     *  Pass a message to a worker, call this from the consumer callback
+     *
+     *  @param  message     the message passed to the callback
+     *  @param  deliveryTag the delivery tag passed to the callback
+     *  @param  redelivered the redelivered flag passed to the callback
+     *  @return bool        false if the message could not be taken over
+     */
+    bool dispatch(const Message &message, uint64_t deliveryTag, bool redelivered);
+
+    /**
+     *  Send the acks for the messages that were handled
+     *
+     *  This is also done when a message is dispatched, but you should call it
+     *  from your event loop too, so that acks are also sent when no new
+     *  messages come in.
+     *
+     *  @return size_t      number of messages that were handled since the last call
+     */
+    size_t flush();
+
+    /**
+     *  Publish a message from the handler
+     *
+     *  The message is copied and passed to the thread of the connection,
+     *  which publishes it on the channel of the dispatcher in flush(). When
+     *  this is not called from a worker thread, the message is published
+     *  right away, so it should then be called from the thread of the connection.
+     *
+     *  @param  exchange    the exchange to publish to
+     *  @param  routingKey  the routing key
+     *  @param  envelope    the full envelope to send
+     *  @return bool
+     */
+    bool publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope);
+
+    /**
+     *  Install a callback that sends the acks, instead of the channel
+     *
+     *  The callback is called from flush(), in the thread of the connection,
+     *  with the same arguments as Channel::ack().
+     *
+     *  @param  callback
+     */
+    void onAck(const AckCallback &callback)
+    {
+        _ack = callback;
+    }
+
+    /**
+     *  Install a callback that sends the rejects of messages for which the
+     *  handler threw an exception, instead of the channel
+     *  @param  callback
+     */
+    void onReject(const AckCallback &callback)
+    {
+        _reject = callback;
+    }
+
+    /**
+     *  Number of messages that were dispatched, but not yet acked
+     *  @return size_t
+     */
+    size_t pending() const
+    {
+        return _outstanding.size();
+    }
+
+    /**
+     *  Keys to dispatch on
+     *  @param  message
+     *  @return StringView
+     */
+    static StringView routingKey(const Message &message)
+    {
+        return message.routingKeyView();
+    }
+
+    static StringView correlationID(const Message &message)
+    {
+        return message.correlationIDView();
+    }
+
+    /**
+     *  Key callback that dispatches on the string value of a header
+     *  @param  name        name of the header
+     *  @return KeyCallback
+     */
+    static KeyCallback header(const std::string &name)
+    {
+        return [name](const Message &message) -> StringView {
+            return message.headersView().get(name).string();
+        };
+    }
+};
+
+/**
+ *  End namespace
+ */
+}
@@ -21,12 +21,54 @@ class Field
 protected:
     /**
      *  Decode a field by fetching a type and full field from a frame
-     *  The returned field is allocated on the heap!
+     *  The returned field is constructed in the buffer if it fits, and
+     *  allocated on the heap otherwise
      *  @param  frame
+     *  @param  buffer  memory to construct the field in
+     *  @param  size    size of the buffer
      *  @return Field*
      */
-    static Field *decode(ReceivedFrame &frame);
-    
+    static Field *decode(ReceivedFrame &frame, void *buffer = nullptr, size_t size = 0);
+
+    /**
+     *  Helper function to copy a field into a buffer, or onto the heap if
+     *  the buffer is too small
+     *  @param  field
+     *  @param  buffer
+     *  @param  size
+     *  @return Field*
+     */
+    template <typename T>
+    static Field *copy(const T &field, void *buffer, size_t size)
+    {
+        // construct in the buffer if there is enough room
+        if (sizeof(T) <= size) return new (buffer) T(field);
+
+        // otherwise we need a heap allocation
+        return new T(field);
+    }
+
+    /**
+     *  Helper to move a field into a buffer that is big enough for it
+     *  @param  field
+     *  @param  buffer
+     *  @return Field*
+     */
+    template <typename T>
+    static Field *move(T &field, void *buffer) noexcept
+    {
+        // the field value relies on this when it is moved itself
+        static_assert(std::is_nothrow_move_constructible<T>::value, "fields should be moved without throwing");
+
+        // construct in the buffer
+        return new (buffer) T(std::move(field));
+    }
+
+    /**
+     *  The field value may decode and copy fields
+     */
+    friend class FieldValue;
+
 public:
     /**
      *  Destructor
@@ -39,6 +81,23 @@ public:
      */
     virtual std::shared_ptr<Field> clone() const = 0;
 
+    /**
+     *  Create a copy of this object in a buffer, or on the heap if the
+     *  buffer is too small
+     *  @param  buffer  memory to construct the copy in
+     *  @param  size    size of the buffer
+     *  @return Field*  the copy (which points into the buffer if it fitted)
+     */
+    virtual Field *copy(void *buffer, size_t size) const = 0;
+
+    /**
+     *  Move this object into a buffer, this is only used for objects that
+     *  were copied into a buffer of the same size before
+     *  @param  buffer  memory to construct the object in
+     *  @return Field*  the object in the buffer
+     */
+    virtual Field *move(void *buffer) noexcept = 0;
+
     /**
      *  Get the size this field will take when
      *  encoded in the AMQP wire-frame format
@@ -0,0 +1,185 @@
+#pragma once
+/**
+ *  FieldValue.h
+ *
+ *  Storage for a single field inside a table or an array. Scalars, strings,
+ *  and nested tables and arrays are constructed inside the value itself, so
+ *  that storing a field does not require a heap allocation of its own.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class FieldValue
+{
+private:
+    /**
+     *  Inline storage, big enough for all string and numeric fields
+     *  @var char[]
+     */
+    alignas(LongString) char _buffer[sizeof(LongString)];
+
+    /**
+     *  The field, this points to the buffer when the field fitted in it
+     *  @var Field
+     */
+    Field *_field = nullptr;
+
+    /**
+     *  Is the field stored inside the buffer?
+     *  @return bool
+     */
+    bool local() const
+    {
+        return (const void *)_field == (const void *)_buffer;
+    }
+
+    /**
+     *  Destruct the current field
+     */
+    void clear()
+    {
+        // fields in the buffer are only destructed, others are deallocated too
+        if (local()) _field->~Field();
+        else delete _field;
+
+        // forget the field
+        _field = nullptr;
+    }
+
+public:
+    /**
+     *  Constructor to copy a field
+     *  @param  field
+     */
+    FieldValue(const Field &field) : _field(field.copy(_buffer, sizeof(_buffer))) {}
+
+    /**
+     *  Constructor to decode a field (type and value) from a frame
+     *  If the type is not supported, the value is invalid
+     *  @param  frame
+     */
+    FieldValue(ReceivedFrame &frame) : _field(Field::decode(frame, _buffer, sizeof(_buffer))) {}
+
+    /**
+     *  Copy constructor
+     *  @param  that
+     */
+    FieldValue(const FieldValue &that) : _field(that._field ? that._field->copy(_buffer, sizeof(_buffer)) : nullptr) {}
+
+    /**
+     *  Move constructor
+     *  @param  that
+     */
+    FieldValue(FieldValue &&that) noexcept
+    {
+        // fields on the heap can be taken over, others are moved to our buffer
+        if (!that.local()) std::swap(_field, that._field);
+        else _field = that._field->move(_buffer);
+    }
+
+    /**
+     *  Destructor
+     */
+    ~FieldValue()
+    {
+        // destruct the field
+        if (_field) clear();
+    }
+
+    /**
+     *  Assign a different field
+     *  @param  field
+     *  @return FieldValue
+     */
+    FieldValue &operator=(const Field &field)
+    {
+        // skip self assignment
+        if (&field == _field) return *this;
+
+        // the field could be part of the current value (a member of a nested
+        // table for example) so it is copied before the current value is gone
+        FieldValue value(field);
+
+        // move it in place
+        return operator=(std::move(value));
+    }
+
+    /**
+     *  Assignment operator
+     *  @param  that
+     *  @return FieldValue
+     */
+    FieldValue &operator=(const FieldValue &that)
+    {
+        // skip self assignment
+        if (this == &that) return *this;
+
+        // replace the field
+        if (_field) clear();
+        if (that._field) _field = that._field->copy(_buffer, sizeof(_buffer));
+
+        // allow chaining
+        return *this;
+    }
+
+    /**
+     *  Move assignment operator
+     *  @param  that
+     *  @return FieldValue
+     */
+    FieldValue &operator=(FieldValue &&that) noexcept
+    {
+        // skip self assignment
+        if (this == &that) return *this;
+
+        // remove the current field
+        if (_field) clear();
+
+        // fields on the heap can be taken over, others are moved to our buffer
+        if (!that.local()) std::swap(_field, that._field);
+        else _field = that._field->move(_buffer);
+
+        // allow chaining
+        return *this;
+    }
+
+    /**
+     *  Is this a valid value?
+     *  @return bool
+     */
+    bool valid() const
+    {
+        return _field != nullptr;
+    }
+
+    /**
+     *  Access to the field
+     *  @return Field
+     */
+    const Field &operator*() const
+    {
+        return *_field;
+    }
+
+    /**
+     *  Access to the field
+     *  @return Field
+     */
+    const Field *operator->() const
+    {
+        return _field;
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
@@ -0,0 +1,230 @@
+#pragma once
+/**
+ *  FieldView.h
+ *
+ *  Read-only view on a single encoded field inside a table or an array. The
+ *  view refers to the raw bytes, and converts them on request, without
+ *  allocating any memory. It is only valid for as long as those bytes exist.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class FieldView
+{
+private:
+    /**
+     *  The type ID of the field, or 0 for an invalid view
+     *  @var char
+     */
+    char _type;
+
+    /**
+     *  Pointer to the encoded value
+     *  @var const char *
+     */
+    const char *_data;
+
+    /**
+     *  Number of bytes of the encoded value
+     *  @var uint32_t
+     */
+    uint32_t _size;
+
+    /**
+     *  Helper function to read a big endian number from the value
+     *  @return T
+     */
+    template <typename T>
+    T read() const
+    {
+        // copy the bytes and convert to host byte order
+        T value;
+        memcpy(&value, _data, sizeof(T));
+
+        // convert based on the size
+        switch (sizeof(T))
+        {
+            case 2: return (T)be16toh((uint16_t)value);
+            case 4: return (T)be32toh((uint32_t)value);
+            case 8: return (T)be64toh((uint64_t)value);
+            default: return value;
+        }
+    }
+
+    /**
+     *  Helper function to read a floating point value
+     *
+     *  Floating point values are stored without conversion, just like the
+     *  received frame and the output buffer do
+     *
+     *  @return T
+     */
+    template <typename T>
+    T real() const
+    {
+        T value;
+        memcpy(&value, _data, sizeof(T));
+        return value;
+    }
+
+public:
+    /**
+     *  Construct an invalid view
+     */
+    FieldView() : _type(0), _data(nullptr), _size(0) {}
+
+    /**
+     *  Construct a view on an encoded value
+     *  @param  type    the type ID
+     *  @param  data    the encoded value
+     *  @param  size    size of the encoded value
+     */
+    FieldView(char type, const char *data, uint32_t size) : _type(type), _data(data), _size(size) {}
+
+    /**
+     *  Size of an encoded value of a certain type
+     *  @param  type        the type ID
+     *  @param  data        the encoded value
+     *  @param  available   number of bytes available in the buffer
+     *  @return uint32_t    the size, or 0 if the value is invalid or does not fit
+     */
+    static uint32_t measure(char type, const char *data, uint32_t available);
+
+    /**
+     *  Is this a valid view? Views on fields that do not exist are invalid
+     *  @return bool
+     */
+    bool valid() const
+    {
+        return _type != 0;
+    }
+
+    /**
+     *  The type ID of the field
+     *  @return char
+     */
+    char typeID() const
+    {
+        return _type;
+    }
+
+    /**
+     *  The encoded value
+     *  @return const char *
+     */
+    const char *data() const
+    {
+        return _data;
+    }
+
+    /**
+     *  Size of the encoded value
+     *  @return uint32_t
+     */
+    uint32_t size() const
+    {
+        return _size;
+    }
+
+    /**
+     *  Check the type of the field
+     *  @return bool
+     */
+    bool isBoolean() const { return _type == 't'; }
+    bool isInteger() const { return _type != 0 && strchr("bBUuIiLlT", _type) != nullptr; }
+    bool isReal() const { return _type == 'f' || _type == 'd' || _type == 'D'; }
+    bool isString() const { return _type == 's' || _type == 'S'; }
+    bool isArray() const { return _type == 'A'; }
+    bool isTable() const { return _type == 'F'; }
+
+    /**
+     *  Get the value as a boolean
+     *  @return bool
+     */
+    bool boolean() const
+    {
+        // booleans, and all numeric values that are not zero
+        return isBoolean() ? _data[0] != 0 : integer() != 0;
+    }
+
+    /**
+     *  Get the value as a signed integer
+     *  Non-integer fields return 0
+     *  @return int64_t
+     */
+    int64_t integer() const
+    {
+        switch (_type)
+        {
+            case 't':   return _data[0] != 0;
+            case 'b':   return (int8_t)_data[0];
+            case 'B':   return (uint8_t)_data[0];
+            case 'U':   return read<int16_t>();
+            case 'u':   return read<uint16_t>();
+            case 'I':   return read<int32_t>();
+            case 'i':   return read<uint32_t>();
+            case 'L':   return read<int64_t>();
+            case 'l':   return read<uint64_t>();
+            case 'T':   return read<uint64_t>();
+            default:    return 0;
+        }
+    }
+
+    /**
+     *  Get the value as a floating point number
+     *  Integer fields are converted, other fields return 0
+     *  @return double
+     */
+    double number() const
+    {
+        switch (_type)
+        {
+            case 'f':   return real<float>();
+            case 'd':   return real<double>();
+            case 'D':   return FieldView('i', _data + 1, 4).integer() / pow(10, (uint8_t)_data[0]);
+            default:    return integer();
+        }
+    }
+
+    /**
+     *  Get the value as a string, without copying it
+     *  Non-string fields return an empty view
+     *  @return StringView
+     */
+    StringView string() const
+    {
+        switch (_type)
+        {
+            case 's':   return StringView(_data + 1, _size - 1);
+            case 'S':   return StringView(_data + 4, _size - 4);
+            default:    return StringView();
+        }
+    }
+
+    /**
+     *  Get the value as a nested table
+     *  Non-table fields return an empty view
+     *  @return TableView
+     */
+    TableView table() const;
+
+    /**
+     *  Get the value as a nested array
+     *  Non-array fields return an empty view
+     *  @return ArrayView
+     */
+    ArrayView array() const;
+};
+
+/**
+ *  End of namespace
+ */
+}
@@ -21,18 +21,114 @@ namespace AMQP {
  */
 class Message : public Envelope
 {
+public:
+    /**
+     *  A part of the body
+     */
+    struct Segment
+    {
+        /**
+         *  The data and its size
+         *  @var    const char *
+         *  @var    size_t
+         */
+        const char *data;
+        size_t size;
+
+        /**
+         *  Constructor
+         *  @param  data
+         *  @param  size
+         */
+        Segment(const char *data, size_t size) : data(data), size(size) {}
+    };
+
 protected:
     /**
      *  The exchange to which it was originally published
-     *  @var    string
+     *
+     *  The view refers to the buffer that was passed to Connection::parse(),
+     *  and only points to the string member once a copy was made
+     *
+     *  @var    StringView
      */
-    std::string _exchange;
+    mutable StringView _exchange;
     
     /**
      *  The routing key that was originally used
+     *  @var    StringView
+     */
+    mutable StringView _routingKey;
+
+    /**
+     *  The tag of the consumer that received the message (empty for messages
+     *  that were fetched with a get operation)
+     *  @var    StringView
+     */
+    mutable StringView _consumerTag;
+
+    /**
+     *  Copies of the strings, made on request or when the buffer goes away
      *  @var    string
      */
-    std::string _routingKey;
+    mutable std::string _exchangeCopy;
+    mutable std::string _routingKeyCopy;
+    mutable std::string _consumerTagCopy;
+
+    /**
+     *  The parts of the body, when it was received in multiple frames
+     *  that are still in the buffer that was passed to parse()
+     *  @var    std::vector<Segment>
+     */
+    mutable std::vector<Segment> _segments;
+
+    /**
+     *  Copy a view into a string (unless that already happened), and let
+     *  the view point to the copy
+     *  @param  view
+     *  @param  copy
+     *  @return string
+     */
+    static const std::string &copy(StringView &view, std::string &copy)
+    {
+        // leap out if the view already refers to the copy
+        if (view.data() == copy.data() && view.size() == copy.size()) return copy;
+
+        // copy the data (this reuses the capacity of the string)
+        copy.assign(view.data(), view.size());
+
+        // the view now refers to our own copy
+        view = StringView(copy);
+
+        // done
+        return copy;
+    }
+
+    /**
+     *  Make sure that the message no longer refers to the input buffer
+     *  This is called when the buffer passed to parse() is about to be released
+     */
+    void preserve()
+    {
+        copy(_exchange, _exchangeCopy);
+        copy(_routingKey, _routingKeyCopy);
+        copy(_consumerTag, _consumerTagCopy);
+    }
+
+    /**
+     *  Hand the message over to an OwnedMessage, this returns nullptr if the
+     *  message can not be taken away from the library
+     *  @return Message
+     */
+    virtual const Message *detach() const
+    {
+        return nullptr;
+    }
+
+    /**
+     *  The owned message may detach us
+     */
+    friend class OwnedMessage;
     
 protected:
     /**
@@ -40,9 +136,10 @@ protected:
      *  instantiate a message
      *  @param  exchange
      *  @param  routingKey
+     *  @param  consumerTag
      */
-    Message(const std::string &exchange, const std::string &routingKey) :
-        Envelope(nullptr, 0), _exchange(exchange), _routingKey(routingKey)
+    Message(const StringView &exchange, const StringView &routingKey, const StringView &consumerTag = StringView()) :
+        Envelope(nullptr, 0), _exchange(exchange), _routingKey(routingKey), _consumerTag(consumerTag)
     {}
     
 public:
@@ -53,21 +150,83 @@ public:
 
     /**
      *  The exchange to which it was originally published
-     *  @var    string
+     *
+     *  The first call copies the name into the message, use exchangeView()
+     *  to access it without copying
+     *
+     *  @return string
      */
     const std::string &exchange() const
     {
-        return _exchange;
+        return copy(_exchange, _exchangeCopy);
     }
     
     /**
      *  The routing key that was originally used
-     *  @var    string
+     *
+     *  The first call copies the key into the message, use routingKeyView()
+     *  to access it without copying
+     *
+     *  @return string
      */
     const std::string &routingKey() const
+    {
+        return copy(_routingKey, _routingKeyCopy);
+    }
+
+    /**
+     *  The tag of the consumer that received the message
+     *  @return string
+     */
+    const std::string &consumerTag() const
+    {
+        return copy(_consumerTag, _consumerTagCopy);
+    }
+
+    /**
+     *  Views on the exchange, routing key and consumer tag
+     *
+     *  These do not copy anything, but the returned views are only valid while
+     *  the message callback runs. Use StringView::str() to take ownership.
+     *
+     *  @return StringView
+     */
+    const StringView &exchangeView() const
+    {
+        return _exchange;
+    }
+
+    const StringView &routingKeyView() const
     {
         return _routingKey;
     }
+
+    const StringView &consumerTagView() const
+    {
+        return _consumerTag;
+    }
+
+    /**
+     *  The body as a list of segments
+     *
+     *  A body that was received in multiple frames is not copied into one
+     *  buffer when all frames were passed to Connection::parse() at once,
+     *  the segments point straight into the frames. This is useful for
+     *  consumers that can handle scattered data, like a hash function or
+     *  writev(). Calling body() still gives the body in one piece, but has
+     *  to copy the segments for that. Like the views, the segments are only
+     *  valid while the message callback runs.
+     *
+     *  @return std::vector<Segment>
+     */
+    const std::vector<Segment> &segments() const
+    {
+        // a body in one piece is a single segment
+        if (_segments.empty() && _body && _bodySize > 0) _segments.emplace_back(_body, _bodySize);
+
+        // done
+        return _segments;
+    }
 };
 
 /**
@@ -0,0 +1,164 @@
+#pragma once
+/**
+ *  MessageBatch.h
+ *
+ *  All messages for a consumer that were decoded by a single call to
+ *  Connection::parse(). Consumers that install an onReceivedBatch() callback
+ *  get their messages in batches, so that they can be processed in one go,
+ *  and be acknowledged with a single ack with the multiple flag.
+ *
+ *  The batch, and the messages in it, are only valid during the callback.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  A single message in a batch
+ */
+class Delivery
+{
+private:
+    /**
+     *  The message
+     *  @var Message
+     */
+    const Message *_message;
+
+    /**
+     *  The delivery tag
+     *  @var uint64_t
+     */
+    uint64_t _deliveryTag;
+
+    /**
+     *  Is this a redelivered message?
+     *  @var bool
+     */
+    bool _redelivered;
+
+public:
+    /**
+     *  Constructor
+     *  @param  message
+     *  @param  deliveryTag
+     *  @param  redelivered
+     */
+    Delivery(const Message *message, uint64_t deliveryTag, bool redelivered) :
+        _message(message), _deliveryTag(deliveryTag), _redelivered(redelivered) {}
+
+    /**
+     *  The message
+     *  @return Message
+     */
+    const Message &message() const
+    {
+        return *_message;
+    }
+
+    /**
+     *  The delivery tag
+     *  @return uint64_t
+     */
+    uint64_t deliveryTag() const
+    {
+        return _deliveryTag;
+    }
+
+    /**
+     *  Is this a redelivered message?
+     *  @return bool
+     */
+    bool redelivered() const
+    {
+        return _redelivered;
+    }
+};
+
+/**
+ *  Class definition
+ */
+class MessageBatch
+{
+private:
+    /**
+     *  The deliveries
+     *  @var Delivery
+     */
+    const Delivery *_deliveries;
+
+    /**
+     *  Number of deliveries
+     *  @var size_t
+     */
+    size_t _size;
+
+public:
+    /**
+     *  Constructor
+     *  @param  deliveries
+     *  @param  size
+     */
+    MessageBatch(const Delivery *deliveries, size_t size) : _deliveries(deliveries), _size(size) {}
+
+    /**
+     *  Number of messages in the batch
+     *  @return size_t
+     */
+    size_t size() const
+    {
+        return _size;
+    }
+
+    /**
+     *  Is the batch empty?
+     *  @return bool
+     */
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /**
+     *  Get a message
+     *  @param  index
+     *  @return Delivery
+     */
+    const Delivery &operator[](size_t index) const
+    {
+        return _deliveries[index];
+    }
+
+    /**
+     *  The first and last message
+     *  @return Delivery
+     */
+    const Delivery &front() const { return _deliveries[0]; }
+    const Delivery &back() const { return _deliveries[_size - 1]; }
+
+    /**
+     *  Iterate over the messages
+     *  @return const Delivery *
+     */
+    const Delivery *begin() const { return _deliveries; }
+    const Delivery *end() const { return _deliveries + _size; }
+
+    /**
+     *  The highest delivery tag in the batch, all messages can be acked at
+     *  once by passing this tag to Channel::ack() with the multiple flag
+     *  @return uint64_t
+     */
+    uint64_t deliveryTag() const
+    {
+        return _size == 0 ? 0 : back().deliveryTag();
+    }
+};
+
+/**
+ *  End namespace
+ */
+}
@@ -0,0 +1,296 @@
+#pragma once
+/**
+ *  NumericArray.h
+ *
+ *  Array in which all elements have the same numeric type, like a list of
+ *  sample timestamps. The values are stored in a contiguous vector, and are
+ *  encoded and decoded in a single loop, without creating a field object
+ *  for every element. On the wire it is an ordinary field array.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Template for numeric arrays
+ */
+template<typename T, char F>
+class NumericArray : public Field
+{
+private:
+    /**
+     *  The values
+     *  @var std::vector<T>
+     */
+    std::vector<T> _values;
+
+    /**
+     *  Helper function to convert a value between host and network byte order
+     *  Floating point values are not converted, just like the output buffer does
+     *  @param  value
+     *  @return T
+     */
+    static T convert(T value)
+    {
+        // floating point values are stored as they are
+        if (std::is_floating_point<T>::value) return value;
+
+        // convert based on the size
+        switch (sizeof(T))
+        {
+            case 2: return (T)be16toh((uint16_t)value);
+            case 4: return (T)be32toh((uint32_t)value);
+            case 8: return (T)be64toh((uint64_t)value);
+            default: return value;
+        }
+    }
+
+public:
+    /**
+     *  Constructor for an empty array
+     */
+    NumericArray() {}
+
+    /**
+     *  Constructor
+     *  @param  values
+     */
+    NumericArray(std::vector<T> values) : _values(std::move(values)) {}
+
+    /**
+     *  Constructor
+     *  @param  values
+     */
+    NumericArray(std::initializer_list<T> values) : _values(values) {}
+
+    /**
+     *  Copy constructor
+     *  @param  that
+     */
+    NumericArray(const NumericArray &that) : _values(that._values) {}
+
+    /**
+     *  Move constructor
+     *  @param  that
+     */
+    NumericArray(NumericArray &&that) noexcept : _values(std::move(that._values)) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~NumericArray() {}
+
+    /**
+     *  Decode an encoded array into a vector of values
+     *
+     *  This only succeeds if all elements have the type of this array, for
+     *  other arrays false is returned and the result is left empty
+     *
+     *  @param  array   the encoded array
+     *  @param  result  vector to store the values in
+     *  @return bool
+     */
+    static bool decode(const ArrayView &array, std::vector<T> &result)
+    {
+        // forget previous values
+        result.clear();
+
+        // every element is a type followed by the value
+        const char *data = array.data() + 4;
+        size_t size = array.size() - 4;
+        const size_t stride = 1 + sizeof(T);
+
+        // the elements should fit exactly
+        if (size % stride != 0) return false;
+
+        // all elements should have the right type
+        for (size_t pos = 0; pos < size; pos += stride) if (data[pos] != F) return false;
+
+        // convert all values in one go
+        result.resize(size / stride);
+        for (size_t i = 0; i < result.size(); i++)
+        {
+            // copy the value and convert to host byte order
+            T value;
+            memcpy(&value, data + i * stride + 1, sizeof(T));
+            result[i] = convert(value);
+        }
+
+        // done
+        return true;
+    }
+
+    /**
+     *  Decode an array that was already parsed into a vector of values
+     *
+     *  This only succeeds if all elements have the type of this array, for
+     *  other arrays false is returned and the result is left empty
+     *
+     *  @param  array   the array
+     *  @param  result  vector to store the values in
+     *  @return bool
+     */
+    static bool decode(const Array &array, std::vector<T> &result)
+    {
+        // forget previous values
+        result.clear();
+
+        // all elements should have the right type
+        for (auto &field : array._fields) if (field->typeID() != F) return false;
+
+        // copy the values, the types are known so no virtual casts are needed
+        result.reserve(array._fields.size());
+        for (auto &field : array._fields) result.push_back(static_cast<const NumericField<T, F>&>(*field).value());
+
+        // done
+        return true;
+    }
+
+    /**
+     *  Create a new instance of this object
+     *  @return Field*
+     */
+    virtual std::shared_ptr<Field> clone() const override
+    {
+        return std::make_shared<NumericArray>(*this);
+    }
+
+    /**
+     *  Create a copy of this object in a buffer
+     *  @param  buffer
+     *  @param  size
+     *  @return Field*
+     */
+    virtual Field *copy(void *buffer, size_t size) const override
+    {
+        return Field::copy(*this, buffer, size);
+    }
+
+    /**
+     *  Move this object into a buffer
+     *  @param  buffer
+     *  @return Field*
+     */
+    virtual Field *move(void *buffer) noexcept override
+    {
+        return Field::move(*this, buffer);
+    }
+
+    /**
+     *  The values
+     *  @return std::vector
+     */
+    const std::vector<T> &values() const
+    {
+        return _values;
+    }
+
+    /**
+     *  The values, to change them
+     *  @return std::vector
+     */
+    std::vector<T> &values()
+    {
+        return _values;
+    }
+
+    /**
+     *  Get number of elements in the array
+     *  @return uint32_t
+     */
+    uint32_t count() const
+    {
+        return _values.size();
+    }
+
+    /**
+     *  Get the size this field will take when
+     *  encoded in the AMQP wire-frame format
+     *  @return size_t
+     */
+    virtual size_t size() const override
+    {
+        // the size, and a type and value for every element
+        return 4 + _values.size() * (1 + sizeof(T));
+    }
+
+    /**
+     *  Write encoded payload to the given buffer.
+     *  @param  buffer      OutBuffer to write to
+     */
+    virtual void fill(OutBuffer& buffer) const override
+    {
+        // store the size of the elements
+        buffer.add(static_cast<uint32_t>(size() - 4));
+
+        // the type and value of every element
+        char element[1 + sizeof(T)];
+        element[0] = F;
+
+        // convert all values in one go
+        for (auto value : _values)
+        {
+            // convert to network byte order, and add the element
+            value = convert(value);
+            memcpy(element + 1, &value, sizeof(T));
+            buffer.add(element, sizeof(element));
+        }
+    }
+
+    /**
+     *  Get the type ID that is used to identify this type of
+     *  field in a field table
+     *  @return char
+     */
+    virtual char typeID() const override
+    {
+        return 'A';
+    }
+
+    /**
+     *  Output the object to a stream
+     *  @param std::ostream
+     */
+    virtual void output(std::ostream &stream) const override
+    {
+        // prefix
+        stream << "array(";
+
+        // loop through all values
+        for (size_t i = 0; i < _values.size(); i++)
+        {
+            // split with comma
+            if (i > 0) stream << ",";
+
+            // show output
+            stream << "numeric(" << _values[i] << ")";
+        }
+
+        // postfix
+        stream << ")";
+    }
+};
+
+/**
+ *  Concrete numeric array types
+ */
+typedef NumericArray<int8_t, 'b'>   OctetArray;
+typedef NumericArray<uint8_t, 'B'>  UOctetArray;
+typedef NumericArray<int16_t, 'U'>  ShortArray;
+typedef NumericArray<uint16_t, 'u'> UShortArray;
+typedef NumericArray<int32_t, 'I'>  LongArray;
+typedef NumericArray<uint32_t, 'i'> ULongArray;
+typedef NumericArray<int64_t, 'L'>  LongLongArray;
+typedef NumericArray<uint64_t, 'l'> ULongLongArray;
+typedef NumericArray<uint64_t, 'T'> TimestampArray;
+typedef NumericArray<float, 'f'>    FloatArray;
+typedef NumericArray<double, 'd'>   DoubleArray;
+
+/**
+ *  end namespace
+ */
+}
@@ -0,0 +1,168 @@
+#pragma once
+/**
+ *  OwnedMessage.h
+ *
+ *  The message that is passed to a consumer callback belongs to the library,
+ *  and is reused as soon as the callback returns. If you want to keep the
+ *  message, for example to pass it on to a worker thread, you can take it
+ *  over with an OwnedMessage object inside the callback:
+ *
+ *      channel.consume("queue").onReceived([&](const AMQP::Message &message, uint64_t deliveryTag, bool redelivered) {
+ *          queue.push(AMQP::OwnedMessage(message, deliveryTag, redelivered));
+ *      });
+ *
+ *  The contents of the message are moved to a new object: the buffer in
+ *  which the body was reassembled is handed over, so the body is only copied
+ *  when it still refers to the buffer that was passed to Connection::parse().
+ *  The properties are copied and decoded. After that, the message no longer
+ *  depends on the connection, and can be used and destructed in any thread.
+ *  The message that was passed to the callback has no body anymore.
+ *
+ *  Reading the body, the scalar properties, the views on the string
+ *  properties and headersView() does not change the message, so that may
+ *  be done from several threads at the same time. The accessors that return
+ *  a std::string and headers() fill a cache inside the message the first
+ *  time they are called: only use those from one thread at a time.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class OwnedMessage
+{
+private:
+    /**
+     *  The message
+     *  @var Message
+     */
+    const Message *_message = nullptr;
+
+    /**
+     *  The delivery tag
+     *  @var uint64_t
+     */
+    uint64_t _deliveryTag = 0;
+
+    /**
+     *  Is this a redelivered message?
+     *  @var bool
+     */
+    bool _redelivered = false;
+
+public:
+    /**
+     *  Constructor for an empty object
+     */
+    OwnedMessage() {}
+
+    /**
+     *  Constructor that takes over a message
+     *
+     *  This can only be done inside the callback that received the message,
+     *  and only once. Otherwise the object stays empty.
+     *
+     *  @param  message         the message passed to the callback
+     *  @param  deliveryTag     the delivery tag passed to the callback
+     *  @param  redelivered     the redelivered flag passed to the callback
+     */
+    OwnedMessage(const Message &message, uint64_t deliveryTag, bool redelivered) :
+        _message(message.detach()), _deliveryTag(deliveryTag), _redelivered(redelivered) {}
+
+    /**
+     *  Constructor that takes over a message from a batch
+     *  @param  delivery
+     */
+    OwnedMessage(const Delivery &delivery) :
+        OwnedMessage(delivery.message(), delivery.deliveryTag(), delivery.redelivered()) {}
+
+    /**
+     *  The object can not be copied, but it can be moved
+     *  @param  that
+     */
+    OwnedMessage(const OwnedMessage &that) = delete;
+    OwnedMessage(OwnedMessage &&that) :
+        _message(that._message), _deliveryTag(that._deliveryTag), _redelivered(that._redelivered)
+    {
+        // the other object no longer owns the message
+        that._message = nullptr;
+    }
+
+    /**
+     *  Destructor
+     */
+    virtual ~OwnedMessage()
+    {
+        // destruct the message
+        if (_message) delete _message;
+    }
+
+    /**
+     *  Move assignment
+     *  @param  that
+     *  @return OwnedMessage
+     */
+    OwnedMessage &operator=(OwnedMessage &&that)
+    {
+        // skip self assignment
+        if (this == &that) return *this;
+
+        // destruct our current message
+        if (_message) delete _message;
+
+        // take over the message
+        _message = that._message;
+        _deliveryTag = that._deliveryTag;
+        _redelivered = that._redelivered;
+        that._message = nullptr;
+
+        // done
+        return *this;
+    }
+
+    /**
+     *  Does the object hold a message?
+     *  @return bool
+     */
+    explicit operator bool () const
+    {
+        return _message != nullptr;
+    }
+
+    /**
+     *  Access to the message
+     *  @return Message
+     */
+    const Message &operator*() const { return *_message; }
+    const Message *operator->() const { return _message; }
+    const Message *get() const { return _message; }
+
+    /**
+     *  The delivery tag
+     *  @return uint64_t
+     */
+    uint64_t deliveryTag() const
+    {
+        return _deliveryTag;
+    }
+
+    /**
+     *  Is this a redelivered message?
+     *  @return bool
+     */
+    bool redelivered() const
+    {
+        return _redelivered;
+    }
+};
+
+/**
+ *  End namespace
+ */
+}
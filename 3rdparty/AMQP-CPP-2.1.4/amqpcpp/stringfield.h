@@ -49,6 +49,18 @@ public:
         _data = std::string(frame.nextData(size.value()), (size_t) size.value());
     }
 
+    /**
+     *  Copy constructor
+     *  @param  that
+     */
+    StringField(const StringField &that) : _data(that._data) {}
+
+    /**
+     *  Move constructor
+     *  @param  that
+     */
+    StringField(StringField &&that) noexcept : _data(std::move(that._data)) {}
+
     /**
      *  Clean up memory used
      */
@@ -64,6 +76,27 @@ public:
         return std::make_shared<StringField>(_data);
     }
 
+    /**
+     *  Create a copy of this object in a buffer
+     *  @param  buffer
+     *  @param  size
+     *  @return Field*
+     */
+    virtual Field *copy(void *buffer, size_t size) const override
+    {
+        return Field::copy(*this, buffer, size);
+    }
+
+    /**
+     *  Move this object into a buffer
+     *  @param  buffer
+     *  @return Field*
+     */
+    virtual Field *move(void *buffer) noexcept override
+    {
+        return Field::move(*this, buffer);
+    }
+
     /**
      *  Assign a new value
      *
@@ -0,0 +1,220 @@
+#pragma once
+/**
+ *  TableView.h
+ *
+ *  Read-only view on an encoded field table. Nothing is decoded up front:
+ *  looking up a field walks over the raw bytes, and returns a view on the
+ *  value, so no memory is allocated. The view is only valid for as long as
+ *  the bytes it refers to exist.
+ *
+ *  Invalid data is not reported, iterating simply stops at the first field
+ *  that can not be parsed. Use valid() to check the whole table up front.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class TableView
+{
+private:
+    /**
+     *  Pointer to the encoded data, starting with the size
+     *  @var const char *
+     */
+    const char *_data;
+
+    /**
+     *  Number of bytes used by the fields (without the size)
+     *  @var uint32_t
+     */
+    uint32_t _size;
+
+public:
+    /**
+     *  Iterator over the fields in the table
+     */
+    class iterator
+    {
+    private:
+        /**
+         *  Current position, and the end of the data
+         *  @var const char *
+         */
+        const char *_pos;
+        const char *_end;
+
+        /**
+         *  Name of the current field
+         *  @var StringView
+         */
+        StringView _name;
+
+        /**
+         *  Value of the current field
+         *  @var FieldView
+         */
+        FieldView _value;
+
+        /**
+         *  Parse the field at the current position
+         */
+        void parse();
+
+    public:
+        /**
+         *  Constructor
+         *  @param  pos
+         *  @param  end
+         */
+        iterator(const char *pos, const char *end) : _pos(pos), _end(end) { parse(); }
+
+        /**
+         *  Name and value of the current field
+         *  @return StringView / FieldView
+         */
+        const StringView &name() const { return _name; }
+        const FieldView &value() const { return _value; }
+
+        /**
+         *  The iterator itself is the current element
+         *  @return iterator
+         */
+        const iterator &operator*() const { return *this; }
+
+        /**
+         *  Move to the next field
+         *  @return iterator
+         */
+        iterator &operator++()
+        {
+            // skip over the current field, and parse the next one
+            _pos = _value.data() + _value.size();
+            parse();
+            return *this;
+        }
+
+        /**
+         *  Compare iterators
+         *  @param  that
+         *  @return bool
+         */
+        bool operator==(const iterator &that) const { return _pos == that._pos; }
+        bool operator!=(const iterator &that) const { return _pos != that._pos; }
+    };
+
+    /**
+     *  Construct an empty view
+     */
+    TableView() : _data("\0\0\0\0"), _size(0) {}
+
+    /**
+     *  Construct a view on an encoded table
+     *  If the buffer is too small for the table, the view is empty
+     *  @param  data    the encoded table, starting with the size
+     *  @param  size    number of bytes available
+     */
+    TableView(const char *data, size_t size);
+
+    /**
+     *  Construct a view on a table that was received in a frame
+     *  @param  frame
+     */
+    TableView(ReceivedFrame &frame);
+
+    /**
+     *  Is the table empty?
+     *  @return bool
+     */
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /**
+     *  The encoded table, starting with the size
+     *  @return const char *
+     */
+    const char *data() const
+    {
+        return _data;
+    }
+
+    /**
+     *  Size of the encoded table, including the leading size
+     *  @return uint32_t
+     */
+    uint32_t size() const
+    {
+        return _size + 4;
+    }
+
+    /**
+     *  Look up a field
+     *  If the field does not exist, an invalid view is returned
+     *  @param  name    field name
+     *  @return FieldView
+     */
+    FieldView get(const StringView &name) const;
+
+    /**
+     *  Look up a field
+     *  @param  name    field name
+     *  @return FieldView
+     */
+    FieldView operator[](const StringView &name) const
+    {
+        return get(name);
+    }
+
+    /**
+     *  Does the table contain a field?
+     *  @param  name    field name
+     *  @return bool
+     */
+    bool contains(const StringView &name) const
+    {
+        return get(name).valid();
+    }
+
+    /**
+     *  Can all fields be parsed, including those of nested tables and arrays?
+     *  @return bool
+     */
+    bool valid() const;
+
+    /**
+     *  Iterate over the fields
+     *  @return iterator
+     */
+    iterator begin() const
+    {
+        return iterator(_data + 4, _data + 4 + _size);
+    }
+
+    /**
+     *  The end of the fields
+     *  @return iterator
+     */
+    iterator end() const
+    {
+        return iterator(_data + 4 + _size, _data + 4 + _size);
+    }
+
+    /**
+     *  Decode the table into a table object that can be modified
+     *  @return Table
+     */
+    Table decode() const;
+};
+
+/**
+ *  End of namespace
+ */
+}
@@ -20,30 +20,29 @@ class Watchable
 {
 private:
     /**
-     *  The monitors
-     *  @var set
+     *  The first monitor, the monitors form a linked list, so that no
+     *  memory has to be allocated when a monitor is created
+     *  @var Monitor
      */
-    std::set<Monitor*> _monitors;
+    Monitor *_monitors = nullptr;
 
+public:
     /**
-     *  Add a monitor
-     *  @param  monitor
+     *  Constructor
      */
-    void add(Monitor *monitor)
-    {
-        _monitors.insert(monitor);
-    }
-    
+    Watchable() {}
+
     /**
-     *  Remove a monitor
-     *  @param  monitor
+     *  Copy constructor, the monitors are not copied
      */
-    void remove(Monitor *monitor)
-    {
-        _monitors.erase(monitor);
-    }
+    Watchable(const Watchable &) {}
+
+    /**
+     *  Assignment, the monitors are left alone
+     *  @return Watchable
+     */
+    Watchable &operator=(const Watchable &) { return *this; }
 
-public:
     /**
      *  Destructor
      */
@@ -0,0 +1,200 @@
+/**
+ *  Main.cpp
+ *
+ *  Micro benchmarks for consuming and publishing messages. No network is
+ *  used: the server side of the connection is played by frames that are
+ *  constructed here and passed to Connection::parse().
+ *
+ *  Every call of the global operator new is counted, so that the benchmarks
+ *  report the number of allocations per message. The program fails when
+ *  consuming messages still allocates memory once the channel is warmed up.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Dependencies
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+#include "includes.h"
+#include "connectionstartokframe.h"
+#include "connectionstartframe.h"
+#include "connectiontuneokframe.h"
+#include "connectionopenframe.h"
+#include "connectiontuneframe.h"
+#include "connectionopenokframe.h"
+#include "channelopenokframe.h"
+#include "basicconsumeokframe.h"
+#include "basicdeliverframe.h"
+#include "basicgetokframe.h"
+#include "messageimpl.h"
+#include "consumedmessage.h"
+#include "basicheaderframe.h"
+#include "bodyframe.h"
+
+/**
+ *  Number of allocations since the program started
+ *  @var size_t
+ */
+static size_t allocations = 0;
+
+/**
+ *  Replacements of the global operators that count the allocations
+ */
+void *operator new(size_t size)
+{
+    allocations++;
+    void *result = malloc(size ? size : 1);
+    if (!result) throw std::bad_alloc();
+    return result;
+}
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *pointer) noexcept { free(pointer); }
+void operator delete[](void *pointer) noexcept { free(pointer); }
+
+/**
+ *  Namespaces to use
+ */
+using namespace AMQP;
+
+/**
+ *  Handler that throws away everything that the client sends
+ */
+class NullHandler : public ConnectionHandler
+{
+public:
+    /**
+     *  Number of bytes that were sent
+     *  @var size_t
+     */
+    size_t bytes = 0;
+
+    /**
+     *  Method that is called when data needs to be sent over the network
+     *  @param  size
+     */
+    virtual void onData(Connection *, const char *, size_t size) override
+    {
+        bytes += size;
+    }
+
+    /**
+     *  Method that is called when the connection failed
+     *  @param  message
+     */
+    virtual void onError(Connection *, const char *message) override
+    {
+        fprintf(stderr, "connection error: %s\n", message);
+        exit(1);
+    }
+};
+
+/**
+ *  Encode a frame
+ *  @param  frame
+ *  @return std::string
+ */
+static std::string encode(const Frame &frame)
+{
+    OutBuffer buffer = frame.buffer();
+    return std::string(buffer.data(), buffer.size());
+}
+
+/**
+ *  Pass frames to the connection, as if they were sent by the server
+ *  @param  connection
+ *  @param  data
+ */
+static void receive(Connection &connection, const std::string &data)
+{
+    connection.parse(data.data(), data.size());
+}
+
+/**
+ *  Result of a benchmark
+ */
+struct Result
+{
+    double allocations;
+    double nanoseconds;
+};
+
+/**
+ *  Run a benchmark
+ *  @param  count       number of messages per call of the function
+ *  @param  rounds      number of calls
+ *  @param  function    the function to measure
+ *  @return Result
+ */
+template <typename Function>
+static Result measure(size_t count, size_t rounds, const Function &function)
+{
+    // warm up, so that buffers and recycled objects exist
+    for (size_t i = 0; i < 10; i++) function();
+
+    // measure the real run
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; i++) function();
+    auto duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+    // calculate the results per message
+    return Result{ double(allocations - before) / (count * rounds), duration.count() / (count * rounds) };
+}
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // the connection, and the handshake with the "server"
+    NullHandler handler;
+    Connection connection(&handler, Login("guest", "guest"), "/");
+    receive(connection, encode(ConnectionStartFrame(0, 9, Table(), "PLAIN", "en_US")));
+    receive(connection, encode(ConnectionTuneFrame(0, 131072, 0)));
+    receive(connection, encode(ConnectionOpenOKFrame()));
+
+    // a channel with a consumer
+    Channel channel(&connection);
+    receive(connection, encode(ChannelOpenOKFrame(1)));
+    size_t received = 0;
+    std::string tag("amq.ctag-0123456789abcdefghijkl");
+    channel.consume("queue", tag).onReceived([&received](const Message &message, uint64_t, bool) {
+        received += message.bodySize();
+    });
+    receive(connection, encode(BasicConsumeOKFrame(1, tag)));
+
+    // a batch of deliveries with a small body and a few properties
+    std::string body(100, 'x');
+    Envelope envelope(body);
+    envelope.setContentType("text/plain");
+    envelope.setCorrelationID("correlation-0001");
+    envelope.setDeliveryMode(2);
+    std::string batch;
+    for (uint64_t i = 1; i <= 100; i++)
+    {
+        batch += encode(BasicDeliverFrame(1, tag, i, false, "exchange", "routing.key.of.the.message"));
+        batch += encode(BasicHeaderFrame(1, envelope));
+        batch += encode(BodyFrame(1, body.data(), body.size()));
+    }
+
+    // consume the batch over and over
+    auto deliver = measure(100, 1000, [&connection, &batch]() { receive(connection, batch); });
+    printf("deliver: %.2f allocations/message, %.0f ns/message\n", deliver.allocations, deliver.nanoseconds);
+
+    // publish messages
+    auto publish = measure(100, 1000, [&channel, &body]() {
+        for (size_t i = 0; i < 100; i++) channel.publish("exchange", "routing.key", body);
+    });
+    printf("publish: %.2f allocations/message, %.0f ns/message\n", publish.allocations, publish.nanoseconds);
+
+    // all messages should have been received
+    if (received != 1010 * 100 * body.size()) { fprintf(stderr, "not all messages were received\n"); return 1; }
+
+    // consuming should not allocate once the channel is warmed up
+    return deliver.allocations > 0.0 ? 1 : 0;
+}
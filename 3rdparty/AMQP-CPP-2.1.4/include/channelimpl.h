@@ -18,12 +18,61 @@ namespace AMQP {
  *  Forward declarations
  */
 class ConsumedMessage;
+class Upload;
 
 /**
  *  Class definition
  */
 class ChannelImpl : public Watchable, public std::enable_shared_from_this<ChannelImpl>
 {
+public:
+    /**
+     *  The callbacks of a consumer
+     */
+    struct Consumer
+    {
+        /**
+         *  Callback for complete messages
+         *  @var    MessageCallback
+         */
+        MessageCallback message;
+
+        /**
+         *  Callback for batches of complete messages
+         *  @var    BatchCallback
+         */
+        BatchCallback batch;
+
+        /**
+         *  Callbacks for streaming consumers, which get the headers of a
+         *  message first, and then the body frame by frame
+         *  @var    MessageCallback
+         *  @var    ChunkCallback
+         *  @var    CompleteCallback
+         */
+        MessageCallback headers;
+        ChunkCallback chunk;
+        CompleteCallback complete;
+
+        /**
+         *  Does the consumer stream messages?
+         *  @return bool
+         */
+        bool streaming() const
+        {
+            return headers || chunk || complete;
+        }
+
+        /**
+         *  Is any callback installed?
+         *  @return bool
+         */
+        explicit operator bool () const
+        {
+            return message || batch || streaming();
+        }
+    };
+
 private:
     /**
      *  Pointer to the connection
@@ -44,10 +93,56 @@ private:
     ErrorCallback _errorCallback;
 
     /**
-     *  Callbacks for all consumers that are active
-     *  @var    std::map<std::string,MessageCallback>
+     *  Callback when the server stops or restarts the flow of messages
+     *  @var    FlowCallback
+     */
+    FlowCallback _flowCallback;
+
+    /**
+     *  Does the server accept published messages? The server can stop
+     *  the flow on a channel when it runs low on resources
+     *  @var    bool
+     */
+    bool _flowing = true;
+
+    /**
+     *  Callbacks for all consumers that are active, indexed by consumer handle
+     *
+     *  Slot zero is reserved for the callback of a pending basic.get operation,
+     *  all other slots are handed out when a basic.consume-ok frame arrives.
+     *  A deque is used because a callback can install a new consumer while
+     *  it runs, which must not move the callback that is being called.
+     *
+     *  @var    std::deque<Consumer>
+     */
+    std::deque<Consumer> _consumers{1};
+
+    /**
+     *  Consumer tags interned to their handle in the _consumers table
+     *  @var    std::unordered_map<std::string,uint32_t>
+     */
+    std::unordered_map<std::string,uint32_t> _handles;
+
+    /**
+     *  The consumer of the previous delivery, so that a run of deliveries for
+     *  the same consumer does not need a lookup in the map above
+     *  @var    std::pair<const std::string,uint32_t>
+     */
+    const std::pair<const std::string,uint32_t> *_lastConsumer = nullptr;
+
+    /**
+     *  Handles of consumers that were cancelled, and that can be reused
+     *  @var    std::vector<uint32_t>
      */
-    std::map<std::string,MessageCallback> _consumers;
+    std::vector<uint32_t> _freeHandles;
+
+    /**
+     *  Memory for the deferred results, this is declared before the deferred
+     *  results themselves, so that it is destructed after them
+     *
+     *  @var    DeferredPool
+     */
+    std::shared_ptr<DeferredPool> _pool = std::make_shared<DeferredPool>();
 
     /**
      *  Pointer to the oldest deferred result (the first one that is going
@@ -64,6 +159,33 @@ private:
      */
     std::shared_ptr<Deferred> _newestCallback;
 
+    /**
+     *  The deferred results of operations that were sent with the nowait flag,
+     *  with the number of synchronous operations that were sent before them.
+     *  The server does not answer these, so they are not in the list of
+     *  deferred results. They are kept until the server answers an operation
+     *  that was sent after them: from then on they can no longer fail.
+     *
+     *  @var    std::deque
+     */
+    std::deque<std::pair<size_t, std::shared_ptr<Deferred>>> _nowaitCallbacks;
+
+    /**
+     *  The deferred results of consumers that were started with the nowait
+     *  flag, they are kept until the consumer is cancelled, so that they can
+     *  report it when the channel fails
+     *
+     *  @var    std::unordered_map
+     */
+    std::unordered_map<std::string, std::shared_ptr<Deferred>> _nowaitConsumers;
+
+    /**
+     *  Number of synchronous operations that were sent, and that were answered
+     *  @var    size_t
+     */
+    size_t _sent = 0;
+    size_t _answered = 0;
+
     /**
      *  The channel number
      *  @var uint16_t
@@ -80,15 +202,52 @@ private:
         state_closed
     } _state = state_closed;
 
+    /**
+     *  A frame that still needs to be sent out
+     */
+    struct QueuedFrame
+    {
+        /**
+         *  Should the frame be handled synchronously?
+         *  @var bool
+         */
+        bool synchronous;
+
+        /**
+         *  The data
+         *  @var OutBuffer
+         */
+        OutBuffer buffer;
+
+        /**
+         *  The streaming publish that starts with this frame, its body has
+         *  to be sent before any other frame on the channel
+         *  @var Upload
+         */
+        std::shared_ptr<Upload> upload;
+
+        /**
+         *  Constructor
+         *  @param  synchronous
+         *  @param  buffer
+         *  @param  upload
+         */
+        QueuedFrame(bool synchronous, OutBuffer &&buffer, const std::shared_ptr<Upload> &upload) :
+            synchronous(synchronous), buffer(std::move(buffer)), upload(upload) {}
+    };
+
     /**
      *  The frames that still need to be send out
-     *
-     *  We store the data as well as whether they
-     *  should be handled synchronously.
-     * 
      *  @var std::queue
      */
-    std::queue<std::pair<bool, OutBuffer>> _queue;
+    std::queue<QueuedFrame> _queue;
+
+    /**
+     *  The streaming publish of which the body is being sent, no other frames
+     *  are sent on the channel until it is complete
+     *  @var Upload
+     */
+    std::shared_ptr<Upload> _upload;
 
     /**
      *  Are we currently operating in synchronous mode?
@@ -102,12 +261,53 @@ private:
      */
     ConsumedMessage *_message = nullptr;
 
+    /**
+     *  Messages for batch consumers that were received, but not yet reported
+     *  @var std::vector<ConsumedMessage*>
+     */
+    std::vector<ConsumedMessage*> _batch;
+
+    /**
+     *  The deliveries that are passed to a batch callback
+     *  @var std::vector<Delivery>
+     */
+    std::vector<Delivery> _deliveries;
+
+    /**
+     *  Message objects that were already reported, and that are kept
+     *  around so that they can be reused for the next incoming messages
+     *  @var std::vector<ConsumedMessage*>
+     */
+    std::vector<ConsumedMessage*> _recycled;
+
+    /**
+     *  Recycle a message, so that its memory can be reused
+     *  @param  message
+     */
+    void recycle(ConsumedMessage *message);
+
+    /**
+     *  Recycle the current message
+     */
+    void recycle();
+
     /**
      *  Attach the connection
      *  @param  connection
      */
     void attach(Connection *connection);
 
+    /**
+     *  Create a deferred result, with memory from the pool
+     *  @param  args            Constructor arguments
+     *  @return std::shared_ptr
+     */
+    template <typename T, typename... Args>
+    std::shared_ptr<T> allocate(Args&&... args)
+    {
+        return std::allocate_shared<T>(DeferredAllocator<T>(_pool), std::forward<Args>(args)...);
+    }
+
     /**
      *  Push a deferred result
      *  @param  result          The deferred result
@@ -115,6 +315,20 @@ private:
      */
     Deferred &push(const std::shared_ptr<Deferred> &deferred);
 
+    /**
+     *  Keep a deferred result for an operation that the server does not answer
+     *  @param  deferred        The deferred result
+     *  @return Deferred        The same object
+     */
+    Deferred &unanswered(const std::shared_ptr<Deferred> &deferred);
+
+    /**
+     *  Release the deferred results of nowait operations that were sent before
+     *  the synchronous operation that the server just answered
+     *  @return bool            Is the channel still valid?
+     */
+    bool confirm();
+
     /**
      *  Send a framen and push a deferred result
      *  @param  frame           The frame to send
@@ -191,6 +405,24 @@ public:
         if (_state != state_connected) callback("Channel is in error state");
     }
 
+    /**
+     *  Callback that is called when the server stops or restarts the flow
+     *  of published messages on the channel
+     *  @param  callback    the callback to execute
+     */
+    void onFlow(const FlowCallback &callback)
+    {
+        // store callback
+        _flowCallback = callback;
+    }
+
+    /**
+     *  Is publishing blocked, because the server stopped the flow on the
+     *  channel, or because it blocked the whole connection?
+     *  @return bool
+     */
+    bool blocked() const;
+
     /**
      *  Pause deliveries on a channel
      *
@@ -260,12 +492,13 @@ public:
      *  @param  source      exchange which binds to target
      *  @param  target      exchange to bind to
      *  @param  routingKey  routing key
+     *  @param  flags       additional flags
      *  @param  arguments   additional arguments for binding
      *
      *  This function returns a deferred handler. Callbacks can be installed
      *  using onSuccess(), onError() and onFinalize() methods.
      */
-    Deferred &bindExchange(const std::string &source, const std::string &target, const std::string &routingkey, const Table &arguments);
+    Deferred &bindExchange(const std::string &source, const std::string &target, const std::string &routingkey, int flags, const Table &arguments);
 
     /**
      *  unbind two exchanges
@@ -273,12 +506,13 @@ public:
      *  @param  source      the source exchange
      *  @param  target      the target exchange
      *  @param  routingkey  the routing key
+     *  @param  flags       additional flags
      *  @param  arguments   additional unbind arguments
      *
      *  This function returns a deferred handler. Callbacks can be installed
      *  using onSuccess(), onError() and onFinalize() methods.
      */
-    Deferred &unbindExchange(const std::string &source, const std::string &target, const std::string &routingkey, const Table &arguments);
+    Deferred &unbindExchange(const std::string &source, const std::string &target, const std::string &routingkey, int flags, const Table &arguments);
 
     /**
      *  remove an exchange
@@ -308,12 +542,13 @@ public:
      *  @param  exchangeName    name of the exchange to bind to
      *  @param  queueName       name of the queue
      *  @param  routingkey      routingkey
+     *  @param  flags           additional flags
      *  @param  arguments       additional arguments
      *
      *  This function returns a deferred handler. Callbacks can be installed
      *  using onSuccess(), onError() and onFinalize() methods.
      */
-    Deferred &bindQueue(const std::string &exchangeName, const std::string &queueName, const std::string &routingkey, const Table &arguments);
+    Deferred &bindQueue(const std::string &exchangeName, const std::string &queueName, const std::string &routingkey, int flags, const Table &arguments);
 
     /**
      *  Unbind a queue from an exchange
@@ -382,6 +617,44 @@ public:
      */
     bool publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope);
 
+    /**
+     *  Publish a message that was received, on this or on another connection
+     *
+     *  @param  exchange    the exchange to publish to
+     *  @param  routingkey  the routing key
+     *  @param  message     the received message
+     */
+    bool republish(const std::string &exchange, const std::string &routingKey, const Message &message);
+
+    /**
+     *  Publish a message of which the body is read with a callback
+     *
+     *  @param  exchange    the exchange to publish to
+     *  @param  routingkey  the routing key
+     *  @param  envelope    the envelope with the meta data (its body is not used)
+     *  @param  size        size of the body
+     *  @param  reader      callback to read the body
+     */
+    bool publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope, uint64_t size, const ReadCallback &reader);
+
+    /**
+     *  Publish a message of which the body is read from a file descriptor
+     *
+     *  @param  exchange    the exchange to publish to
+     *  @param  routingkey  the routing key
+     *  @param  envelope    the envelope with the meta data (its body is not used)
+     *  @param  size        size of the body
+     *  @param  fd          file descriptor to read the body from
+     */
+    bool publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope, uint64_t size, int fd);
+
+    /**
+     *  Send the next body frames of the streaming publish
+     *  @param  max         number of bytes to send (at least one frame is sent)
+     *  @return size_t      number of bytes sent
+     */
+    size_t pump(size_t max);
+
     /**
      *  Set the Quality of Service (QOS) of the entire connection
      *  @param  prefetchCount       maximum number of messages to prefetch
@@ -518,13 +791,29 @@ public:
      */
     bool send(const Frame &frame);
 
+    /**
+     *  Send a frame that starts a streaming publish
+     *  @param  frame       frame to send
+     *  @param  upload      the body that should be sent after the frame
+     *  @return bool        was frame succesfully sent?
+     */
+    bool send(const Frame &frame, const std::shared_ptr<Upload> &upload);
+
+    /**
+     *  Send (a part of) a body, split up in frames
+     *  @param  data        the data to send
+     *  @param  size        size of the data
+     *  @return bool        were the frames succesfully sent?
+     */
+    bool sendBody(const char *data, uint64_t size);
+
     /**
      *  Is this channel waiting for an answer before it can send furher instructions
      *  @return bool
      */
     bool waiting() const
     {
-        return _synchronous || !_queue.empty();
+        return _synchronous || _upload || !_queue.empty();
     }
 
     /**
@@ -548,6 +837,19 @@ public:
         if (monitor.valid()) onSynchronized();
     }
 
+    /**
+     *  Report that the server stopped or restarted the flow of messages
+     *  @param  active      is the flow active?
+     */
+    void reportFlow(bool active)
+    {
+        // store the new state
+        _flowing = active;
+
+        // inform handler
+        if (_flowCallback) _flowCallback(active);
+    }
+
     /**
      *  Report to the handler that the channel is closed
      *
@@ -613,8 +915,8 @@ public:
         // if there was no next callback, the newest callback was just used
         if (!next) _newestCallback = nullptr;
 
-        // we are still valid
-        return true;
+        // the nowait operations that were sent before it succeeded as well
+        return confirm();
     }
 
     /**
@@ -624,28 +926,132 @@ public:
      */
     void reportError(const char *message, bool notifyhandler = true);
 
+    /**
+     *  Handle that is used for messages that belong to no known consumer
+     *  @var    uint32_t
+     */
+    static const uint32_t nohandle = 0xffffffff;
+
     /**
      *  Install a consumer callback
+     *
+     *  The consumer tag is interned to a small integer handle, so that incoming
+     *  messages can be dispatched without comparing strings. The empty tag is
+     *  used for basic.get operations and always maps to handle zero.
+     *
+     *  @param  consumertag     The consumer tag
+     *  @param  consumer        The callbacks to be called
+     */
+    void install(const std::string &consumertag, const Consumer &consumer)
+    {
+        // without a callback, we erase the previously set callback
+        if (!consumer) return uninstall(consumertag);
+
+        // the get-callback has a fixed slot
+        if (consumertag.empty()) 
+        {
+            // store the callback
+            _consumers[0] = consumer;
+            return;
+        }
+
+        // is this tag already known? then we overwrite its callback
+        auto iter = _handles.find(consumertag);
+        if (iter != _handles.end())
+        {
+            // overwrite the callback
+            _consumers[iter->second] = consumer;
+            return;
+        }
+
+        // reuse the slot of a cancelled consumer, or add a new slot
+        uint32_t handle = _consumers.size();
+        if (_freeHandles.empty()) _consumers.push_back(consumer);
+        else
+        {
+            // take a free slot
+            handle = _freeHandles.back();
+            _freeHandles.pop_back();
+            _consumers[handle] = consumer;
+        }
+
+        // remember the handle
+        _handles.emplace(consumertag, handle);
+    }
+
+    /**
+     *  Install a consumer callback for complete messages
      *  @param  consumertag     The consumer tag
      *  @param  callback        The callback to be called
      */
     void install(const std::string &consumertag, const MessageCallback &callback)
     {
-        // install the callback if it is assigned
-        if (callback) _consumers[consumertag] = callback;
+        // the consumer only has a message callback
+        Consumer consumer;
+        consumer.message = callback;
 
-        // otherwise we erase the previously set callback
-        else _consumers.erase(consumertag);
+        // install it
+        install(consumertag, consumer);
     }
 
+    /**
+     *  Release the deferred result of a consumer that was started with the
+     *  nowait flag, this is done when the consumer is cancelled
+     *  @param  consumertag     The consumer tag
+     */
+    void release(const std::string &consumertag);
+
     /**
      *  Uninstall a consumer callback
      *  @param  consumertag     The consumer tag
      */
     void uninstall(const std::string &consumertag)
     {
-        // erase the callback
-        _consumers.erase(consumertag);
+        // the get-callback has a fixed slot
+        if (consumertag.empty())
+        {
+            // erase the callback
+            _consumers[0] = Consumer();
+            return;
+        }
+
+        // find the handle
+        auto iter = _handles.find(consumertag);
+        if (iter == _handles.end()) return;
+
+        // forget the consumer of the previous delivery if it is this one
+        if (_lastConsumer == &*iter) _lastConsumer = nullptr;
+
+        // erase the callbacks, and make the slot available again
+        _consumers[iter->second] = Consumer();
+        _freeHandles.push_back(iter->second);
+        _handles.erase(iter);
+    }
+
+    /**
+     *  Look up the handle of a consumer
+     *
+     *  Deliveries usually come in runs for the same consumer, so the tag is
+     *  first compared with the consumer of the previous delivery. Only when
+     *  that is another consumer, the tag is copied and hashed for a lookup.
+     *
+     *  @param  consumertag     The consumer tag
+     *  @return uint32_t        The handle, or nohandle if the consumer is unknown
+     */
+    uint32_t consumer(const StringView &consumertag)
+    {
+        // same consumer as the previous delivery?
+        if (_lastConsumer && StringView(_lastConsumer->first) == consumertag) return _lastConsumer->second;
+
+        // find the handle
+        auto iter = _handles.find(consumertag);
+        if (iter == _handles.end()) return nohandle;
+
+        // remember it for the next delivery (elements of the map do not move)
+        _lastConsumer = &*iter;
+
+        // found it
+        return iter->second;
     }
 
     /**
@@ -653,6 +1059,49 @@ public:
      */
     void reportMessage();
 
+    /**
+     *  Report the messages that were collected for batch consumers
+     */
+    void reportBatch();
+
+    /**
+     *  Is the message that is being received for a streaming consumer?
+     *  @return bool
+     */
+    bool streaming() const;
+
+    /**
+     *  Report the headers of a message to a streaming consumer
+     */
+    void reportHeaders();
+
+    /**
+     *  Report a part of the body to a streaming consumer
+     *  @param  data        the data
+     *  @param  size        size of the data
+     */
+    void reportChunk(const char *data, uint64_t size);
+
+    /**
+     *  Report to a streaming consumer that the message is complete
+     */
+    void reportComplete();
+
+    /**
+     *  Are there messages for batch consumers that were not yet reported?
+     *  @return bool
+     */
+    bool batched() const
+    {
+        return !_batch.empty();
+    }
+
+    /**
+     *  The pool for the buffers of message bodies
+     *  @return std::shared_ptr<BufferPool>
+     */
+    std::shared_ptr<BufferPool> pool() const;
+
     /**
      *  Create an incoming message
      *  @param  frame
@@ -661,6 +1110,12 @@ public:
     ConsumedMessage *message(const BasicDeliverFrame &frame);
     ConsumedMessage *message(const BasicGetOKFrame &frame);
 
+    /**
+     *  Make sure that the message that is being received no longer refers
+     *  to the input buffer, because that buffer is about to be released
+     */
+    void preserve();
+
     /**
      *  Retrieve the current incoming message
      *  @return ConsumedMessage
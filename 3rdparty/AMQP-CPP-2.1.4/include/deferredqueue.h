@@ -23,6 +23,12 @@ private:
      */
     QueueCallback _queueCallback;
 
+    /**
+     *  Name of the queue, only set when it was declared with the nowait option
+     *  @var    std::string
+     */
+    std::string _name;
+
     /**
      *  Report success for queue declared messages
      *  @param  name            Name of the new queue
@@ -75,6 +81,9 @@ public:
     {
         // store callback
         _queueCallback = callback;
+
+        // if the server does not answer, we call the callback right away
+        if (_nowait && !_failed && callback) callback(_name, 0, 0);
         
         // allow chaining
         return *this;
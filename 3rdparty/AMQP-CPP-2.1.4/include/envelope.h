@@ -25,6 +25,12 @@ protected:
      */
     std::string _str;
 
+    /**
+     *  The body (only used when a shared string was passed to the constructor)
+     *  @var    std::shared_ptr<const std::string>
+     */
+    std::shared_ptr<const std::string> _shared;
+
     /**
      *  Pointer to the body data (the memory buffer is not managed by the AMQP
      *  library!)
@@ -49,13 +55,124 @@ public:
      *  @param  size
      */
     Envelope(const char *body, uint64_t size) : MetaData(), _body(body), _bodySize(size) {}
-    
+
+    /**
+     *  Constructor that refers to a body, without copying it
+     *
+     *  Like the constructor above, the data that the view refers to must be
+     *  valid during the lifetime of the Envelope object. Publishing copies
+     *  the data into the output, so it may be released after publish().
+     *
+     *  @param  body
+     */
+    Envelope(const StringView &body) : MetaData(), _body(body.data()), _bodySize(body.size()) {}
+
     /**
      *  Constructor based on a string
      *  @param  body
      */
     Envelope(const std::string &body) : MetaData(), _str(body), _body(_str.data()), _bodySize(_str.size()) {}
 
+    /**
+     *  Constructor based on a string that is moved into the envelope
+     *  @param  body
+     */
+    Envelope(std::string &&body) : MetaData(), _str(std::move(body)), _body(_str.data()), _bodySize(_str.size()) {}
+
+    /**
+     *  Constructor based on a C string, which is copied (like a string)
+     *  @param  body
+     */
+    Envelope(const char *body) : Envelope(std::string(body)) {}
+
+    /**
+     *  Constructor based on a shared string
+     *
+     *  The envelope keeps a reference to the string, so the same body can be
+     *  used for many envelopes without copying it.
+     *
+     *  @param  body
+     */
+    Envelope(const std::shared_ptr<const std::string> &body) :
+        MetaData(), _shared(body), _body(body ? body->data() : nullptr), _bodySize(body ? body->size() : 0) {}
+
+    /**
+     *  Copy constructor
+     *  @param  that
+     */
+    Envelope(const Envelope &that) :
+        MetaData(that), _str(that._str), _shared(that._shared), _body(that._body), _bodySize(that._bodySize)
+    {
+        // the body could be stored in the string of the other object
+        if (that._body == that._str.data()) _body = _str.data();
+    }
+
+    /**
+     *  Move constructor
+     *  @param  that
+     */
+    Envelope(Envelope &&that) :
+        MetaData(that), _shared(std::move(that._shared)), _body(that._body), _bodySize(that._bodySize)
+    {
+        // the body could be stored in the string of the other object
+        bool owned = that._body == that._str.data();
+
+        // take over the string
+        _str = std::move(that._str);
+
+        // and refer to it
+        if (owned) _body = _str.data();
+    }
+
+    /**
+     *  Assignment operator
+     *  @param  that
+     *  @return Envelope
+     */
+    Envelope &operator=(const Envelope &that)
+    {
+        // skip self assignment
+        if (this == &that) return *this;
+
+        // copy the meta data and the body
+        MetaData::operator=(that);
+        _str = that._str;
+        _shared = that._shared;
+        _bodySize = that._bodySize;
+
+        // the body could be stored in the string of the other object
+        _body = that._body == that._str.data() ? _str.data() : that._body;
+
+        // allow chaining
+        return *this;
+    }
+
+    /**
+     *  Move assignment operator
+     *  @param  that
+     *  @return Envelope
+     */
+    Envelope &operator=(Envelope &&that)
+    {
+        // skip self assignment
+        if (this == &that) return *this;
+
+        // the body could be stored in the string of the other object
+        bool owned = that._body == that._str.data();
+
+        // take over the meta data and the body
+        MetaData::operator=(that);
+        _str = std::move(that._str);
+        _shared = std::move(that._shared);
+        _bodySize = that._bodySize;
+
+        // and refer to it
+        _body = owned ? _str.data() : that._body;
+
+        // allow chaining
+        return *this;
+    }
+
     /**
      *  Destructor
      */
@@ -65,7 +182,7 @@ public:
      *  Access to the full message data
      *  @return buffer
      */
-    const char *body() const
+    virtual const char *body() const
     {
         return _body;
     }
@@ -79,13 +196,22 @@ public:
         return _bodySize;
     }
     
+    /**
+     *  Body as a view, this does not copy the data like message() does
+     *  @return StringView
+     */
+    StringView bodyView() const
+    {
+        return StringView(body(), _bodySize);
+    }
+
     /**
      *  Body as a string
      *  @return string
      */
     std::string message() const
     {
-        return std::string(_body, _bodySize);
+        return std::string(body(), _bodySize);
     }
 };
 
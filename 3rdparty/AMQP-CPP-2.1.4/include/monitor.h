@@ -28,6 +28,13 @@ private:
      */
     Watchable *_watchable;
 
+    /**
+     *  The previous and next monitor of the same object
+     *  @var    Monitor
+     */
+    Monitor *_prev;
+    Monitor *_next;
+
     /**
      *  Invalidate the object
      */
@@ -41,19 +48,31 @@ public:
      *  Constructor
      *  @param  watchable
      */
-    Monitor(Watchable *watchable) : _watchable(watchable)
+    Monitor(Watchable *watchable) : _watchable(watchable), _prev(nullptr), _next(watchable->_monitors)
     {
-        // register with the watchable
-        _watchable->add(this);
+        // register with the watchable, at the front of the list
+        if (_next) _next->_prev = this;
+        _watchable->_monitors = this;
     }
+
+    /**
+     *  Monitors can not be copied
+     *  @param  that
+     */
+    Monitor(const Monitor &that) = delete;
     
     /**
      *  Destructor
      */
     virtual ~Monitor()
     {
-        // remove from watchable
-        if (_watchable) _watchable->remove(this);
+        // nothing to do if the watchable is already gone
+        if (!_watchable) return;
+
+        // remove from the list of the watchable
+        if (_next) _next->_prev = _prev;
+        if (_prev) _prev->_next = _next;
+        else _watchable->_monitors = _next;
     }
     
     /**
@@ -84,6 +84,27 @@ public:
         return std::make_shared<NumericField>(_value);
     }
 
+    /**
+     *  Create a copy of this object in a buffer
+     *  @param  buffer
+     *  @param  size
+     *  @return Field*
+     */
+    virtual Field *copy(void *buffer, size_t size) const override
+    {
+        return Field::copy(*this, buffer, size);
+    }
+
+    /**
+     *  Move this object into a buffer
+     *  @param  buffer
+     *  @return Field*
+     */
+    virtual Field *move(void *buffer) noexcept override
+    {
+        return Field::move(*this, buffer);
+    }
+
     /**
      *  Assign a new value
      *
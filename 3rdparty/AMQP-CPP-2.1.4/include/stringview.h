@@ -0,0 +1,142 @@
+#pragma once
+/**
+ *  StringView.h
+ *
+ *  Non-owning reference to a range of characters. The library uses it to
+ *  expose strings that live in the buffer that was passed to the parse()
+ *  method, so that they do not have to be copied for every message.
+ *
+ *  A view does not manage the memory it points to: it is only valid for as
+ *  long as the referred buffer exists. Call str() to get an owning copy.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class StringView
+{
+private:
+    /**
+     *  Pointer to the first character
+     *  @var const char *
+     */
+    const char *_data;
+
+    /**
+     *  Number of characters
+     *  @var size_t
+     */
+    size_t _size;
+
+public:
+    /**
+     *  Construct an empty view
+     */
+    StringView() : _data(nullptr), _size(0) {}
+
+    /**
+     *  Construct a view on a buffer
+     *  @param  data
+     *  @param  size
+     */
+    StringView(const char *data, size_t size) : _data(data), _size(size) {}
+
+    /**
+     *  Construct a view on a null terminated string
+     *  @param  data
+     */
+    StringView(const char *data) : _data(data), _size(strlen(data)) {}
+
+    /**
+     *  Construct a view on a std::string (the string must outlive the view)
+     *  @param  str
+     */
+    StringView(const std::string &str) : _data(str.data()), _size(str.size()) {}
+
+    /**
+     *  Pointer to the characters (not null terminated!)
+     *  @return const char *
+     */
+    const char *data() const
+    {
+        return _data;
+    }
+
+    /**
+     *  Number of characters
+     *  @return size_t
+     */
+    size_t size() const
+    {
+        return _size;
+    }
+
+    /**
+     *  Is the view empty?
+     *  @return bool
+     */
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /**
+     *  Take ownership: copy the characters into a std::string
+     *  @return std::string
+     */
+    std::string str() const
+    {
+        return std::string(_data, _size);
+    }
+
+    /**
+     *  Cast to a std::string (this copies the characters)
+     *  @return std::string
+     */
+    operator std::string () const
+    {
+        return str();
+    }
+
+    /**
+     *  Compare with a different view
+     *  @param  that
+     *  @return bool
+     */
+    bool equals(const StringView &that) const
+    {
+        return _size == that._size && (_size == 0 || memcmp(_data, that._data, _size) == 0);
+    }
+};
+
+/**
+ *  Comparison operators
+ *  @param  a
+ *  @param  b
+ *  @return bool
+ */
+inline bool operator==(const StringView &a, const StringView &b) { return a.equals(b); }
+inline bool operator!=(const StringView &a, const StringView &b) { return !a.equals(b); }
+
+/**
+ *  Custom output stream operator
+ *  @param  stream
+ *  @param  view
+ *  @return ostream
+ */
+inline std::ostream &operator<<(std::ostream &stream, const StringView &view)
+{
+    return stream.write(view.data(), view.size());
+}
+
+/**
+ *  End of namespace
+ */
+}
@@ -20,7 +20,7 @@ private:
      *  Definition of an array as a vector
      *  @typedef
      */
-    typedef std::vector<std::shared_ptr<Field>> FieldArray;
+    typedef std::vector<FieldValue> FieldArray;
 
     /**
      *  The actual fields
@@ -28,6 +28,12 @@ private:
      */
     FieldArray _fields;
 
+    /**
+     *  Numeric arrays read the fields directly
+     */
+    template <typename T, char F>
+    friend class NumericArray;
+
 public:
     /**
      *  Constructor to construct an array from a received frame
@@ -46,7 +52,7 @@ public:
      *  Move constructor
      *  @param  array
      */
-    Array(Array &&array) : _fields(std::move(array._fields)) {}
+    Array(Array &&array) noexcept : _fields(std::move(array._fields)) {}
 
     /**
      *  Constructor for an empty Array
@@ -67,6 +73,27 @@ public:
         return std::make_shared<Array>(*this);
     }
 
+    /**
+     *  Create a copy of this object in a buffer
+     *  @param  buffer
+     *  @param  size
+     *  @return Field*
+     */
+    virtual Field *copy(void *buffer, size_t size) const override
+    {
+        return Field::copy(*this, buffer, size);
+    }
+
+    /**
+     *  Move this object into a buffer
+     *  @param  buffer
+     *  @return Field*
+     */
+    virtual Field *move(void *buffer) noexcept override
+    {
+        return Field::move(*this, buffer);
+    }
+
     /**
      *  Get the size this field will take when
      *  encoded in the AMQP wire-frame format
@@ -81,21 +108,18 @@ public:
      *  @param  value   field value
      *  @return Array
      */
-    Array set(uint8_t index, const Field &value)
+    Array &set(uint8_t index, const Field &value)
     {
-        // construct a shared pointer
-        auto ptr = value.clone();
-
         // should we overwrite an existing record?
         if (index >= _fields.size())
         {
-            // append index
-            _fields.push_back(ptr);
+            // append the value
+            _fields.emplace_back(value);
         }
         else
         {
-            // overwrite pointer
-            _fields[index] = ptr;
+            // overwrite the value
+            _fields[index] = value;
         }
 
         // allow chaining
@@ -0,0 +1,188 @@
+#pragma once
+/**
+ *  ArrayView.h
+ *
+ *  Read-only view on an encoded field array, the counterpart of the
+ *  TableView for arrays. Elements are parsed when they are accessed, and
+ *  no memory is allocated.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class ArrayView
+{
+private:
+    /**
+     *  Pointer to the encoded data, starting with the size
+     *  @var const char *
+     */
+    const char *_data;
+
+    /**
+     *  Number of bytes used by the elements (without the size)
+     *  @var uint32_t
+     */
+    uint32_t _size;
+
+public:
+    /**
+     *  Iterator over the elements in the array
+     */
+    class iterator
+    {
+    private:
+        /**
+         *  Current position, and the end of the data
+         *  @var const char *
+         */
+        const char *_pos;
+        const char *_end;
+
+        /**
+         *  The current element
+         *  @var FieldView
+         */
+        FieldView _value;
+
+        /**
+         *  Parse the element at the current position
+         */
+        void parse();
+
+    public:
+        /**
+         *  Constructor
+         *  @param  pos
+         *  @param  end
+         */
+        iterator(const char *pos, const char *end) : _pos(pos), _end(end) { parse(); }
+
+        /**
+         *  The current element
+         *  @return FieldView
+         */
+        const FieldView &operator*() const { return _value; }
+        const FieldView *operator->() const { return &_value; }
+
+        /**
+         *  Move to the next element
+         *  @return iterator
+         */
+        iterator &operator++()
+        {
+            // skip over the current element, and parse the next one
+            _pos = _value.data() + _value.size();
+            parse();
+            return *this;
+        }
+
+        /**
+         *  Compare iterators
+         *  @param  that
+         *  @return bool
+         */
+        bool operator==(const iterator &that) const { return _pos == that._pos; }
+        bool operator!=(const iterator &that) const { return _pos != that._pos; }
+    };
+
+    /**
+     *  Construct an empty view
+     */
+    ArrayView() : _data("\0\0\0\0"), _size(0) {}
+
+    /**
+     *  Construct a view on an encoded array
+     *  If the buffer is too small for the array, the view is empty
+     *  @param  data    the encoded array, starting with the size
+     *  @param  size    number of bytes available
+     */
+    ArrayView(const char *data, size_t size);
+
+    /**
+     *  Is the array empty?
+     *  @return bool
+     */
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /**
+     *  The encoded array, starting with the size
+     *  @return const char *
+     */
+    const char *data() const
+    {
+        return _data;
+    }
+
+    /**
+     *  Size of the encoded array, including the leading size
+     *  @return uint32_t
+     */
+    uint32_t size() const
+    {
+        return _size + 4;
+    }
+
+    /**
+     *  Number of elements in the array
+     *  @return uint32_t
+     */
+    uint32_t count() const;
+
+    /**
+     *  Can all elements be parsed, including those of nested tables and arrays?
+     *  @return bool
+     */
+    bool valid() const;
+
+    /**
+     *  Get an element
+     *  If the element does not exist, an invalid view is returned
+     *  @param  index
+     *  @return FieldView
+     */
+    FieldView get(uint32_t index) const;
+
+    /**
+     *  Get an element
+     *  @param  index
+     *  @return FieldView
+     */
+    FieldView operator[](uint32_t index) const
+    {
+        return get(index);
+    }
+
+    /**
+     *  Iterate over the elements
+     *  @return iterator
+     */
+    iterator begin() const
+    {
+        return iterator(_data + 4, _data + 4 + _size);
+    }
+
+    /**
+     *  The end of the elements
+     *  @return iterator
+     */
+    iterator end() const
+    {
+        return iterator(_data + 4 + _size, _data + 4 + _size);
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
@@ -64,7 +64,7 @@ public:
      *  Copy constructor
      *  @param  that
      */
-    BooleanSet(const BooleanSet &that)
+    BooleanSet(const BooleanSet &that) noexcept
     {
         _byte = that._byte;
     }
@@ -83,6 +83,27 @@ public:
         return std::make_shared<BooleanSet>(*this);
     }
 
+    /**
+     *  Create a copy of this object in a buffer
+     *  @param  buffer
+     *  @param  size
+     *  @return Field*
+     */
+    virtual Field *copy(void *buffer, size_t size) const override
+    {
+        return Field::copy(*this, buffer, size);
+    }
+
+    /**
+     *  Move this object into a buffer
+     *  @param  buffer
+     *  @return Field*
+     */
+    virtual Field *move(void *buffer) noexcept override
+    {
+        return Field::move(*this, buffer);
+    }
+
     /**
      *  Output the object to a stream
      *  @param std::ostream
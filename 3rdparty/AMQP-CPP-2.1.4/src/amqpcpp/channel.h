@@ -81,6 +81,32 @@ public:
         _implementation->onError(callback);
     }
 
+    /**
+     *  Callback that is called when the server stops or restarts the flow of
+     *  published messages on this channel. The server does this when it runs
+     *  low on resources. The callback receives whether the flow is active.
+     *
+     *  Only one callback can be registered. Calling this function multiple
+     *  times will remove the old callback.
+     *
+     *  @param  callback    the callback to execute
+     */
+    void onFlow(const FlowCallback &callback)
+    {
+        _implementation->onFlow(callback);
+    }
+
+    /**
+     *  Is publishing blocked? This is the case when the server stopped the
+     *  flow on this channel, or when it blocked the whole connection. The
+     *  publish() method fails while the channel is blocked.
+     *  @return bool
+     */
+    bool blocked() const
+    {
+        return _implementation->blocked();
+    }
+
     /**
      *  Pause deliveries on a channel
      *
@@ -159,6 +185,14 @@ public:
      *      -   durable     exchange survives a broker restart
      *      -   autodelete  exchange is automatically removed when all connected queues are removed
      *      -   passive     only check if the exchange exist
+     *      -   nowait      do not wait for the server to confirm
+     *
+     *  With the nowait flag the server does not send an answer, so the next
+     *  instructions can be sent right away, without waiting for a round trip.
+     *  This is useful when many exchanges, queues and bindings are set up at
+     *  once. The onSuccess() callback is called as soon as it is installed,
+     *  and if the operation fails, the server closes the channel, which is
+     *  reported to the onError() callback of the channel.
      *
      *  @param  name        name of the exchange
      *  @param  type        exchange type
@@ -181,6 +215,7 @@ public:
      *  The following flags can be used for the exchange:
      *
      *      -   ifunused    only delete if no queues are connected
+     *      -   nowait      do not wait for the server to confirm (see declareExchange())
 
      *  @param  name        name of the exchange to remove
      *  @param  flags       optional flags
@@ -193,30 +228,42 @@ public:
     /**
      *  Bind two exchanges to each other
      *
+     *  The following flags can be used:
+     *
+     *      -   nowait      do not wait for the server to confirm (see declareExchange())
+     *
      *  @param  source      the source exchange
      *  @param  target      the target exchange
      *  @param  routingkey  the routing key
+     *  @param  flags       optional flags
      *  @param  arguments   additional bind arguments
      *
      *  This function returns a deferred handler. Callbacks can be installed
      *  using onSuccess(), onError() and onFinalize() methods.
      */
-    Deferred &bindExchange(const std::string &source, const std::string &target, const std::string &routingkey, const Table &arguments) { return _implementation->bindExchange(source, target, routingkey, arguments); }
-    Deferred &bindExchange(const std::string &source, const std::string &target, const std::string &routingkey) { return _implementation->bindExchange(source, target, routingkey, Table()); }
+    Deferred &bindExchange(const std::string &source, const std::string &target, const std::string &routingkey, int flags, const Table &arguments) { return _implementation->bindExchange(source, target, routingkey, flags, arguments); }
+    Deferred &bindExchange(const std::string &source, const std::string &target, const std::string &routingkey, const Table &arguments) { return _implementation->bindExchange(source, target, routingkey, 0, arguments); }
+    Deferred &bindExchange(const std::string &source, const std::string &target, const std::string &routingkey, int flags = 0) { return _implementation->bindExchange(source, target, routingkey, flags, Table()); }
 
     /**
      *  Unbind two exchanges from one another
      *
+     *  The following flags can be used:
+     *
+     *      -   nowait      do not wait for the server to confirm (see declareExchange())
+     *
      *  @param  target      the target exchange
      *  @param  source      the source exchange
      *  @param  routingkey  the routing key
+     *  @param  flags       optional flags
      *  @param  arguments   additional unbind arguments
      *
      *  This function returns a deferred handler. Callbacks can be installed
      *  using onSuccess(), onError() and onFinalize() methods.
      */
-    Deferred &unbindExchange(const std::string &target, const std::string &source, const std::string &routingkey, const Table &arguments) { return _implementation->unbindExchange(target, source, routingkey, arguments); }
-    Deferred &unbindExchange(const std::string &target, const std::string &source, const std::string &routingkey) { return _implementation->unbindExchange(target, source, routingkey, Table()); }
+    Deferred &unbindExchange(const std::string &target, const std::string &source, const std::string &routingkey, int flags, const Table &arguments) { return _implementation->unbindExchange(target, source, routingkey, flags, arguments); }
+    Deferred &unbindExchange(const std::string &target, const std::string &source, const std::string &routingkey, const Table &arguments) { return _implementation->unbindExchange(target, source, routingkey, 0, arguments); }
+    Deferred &unbindExchange(const std::string &target, const std::string &source, const std::string &routingkey, int flags = 0) { return _implementation->unbindExchange(target, source, routingkey, flags, Table()); }
 
     /**
      *  Declare a queue
@@ -229,6 +276,11 @@ public:
      *      -   autodelete  queue is automatically removed when all connected consumers are gone
      *      -   passive     only check if the queue exist
      *      -   exclusive   the queue only exists for this connection, and is automatically removed when connection is gone
+     *      -   nowait      do not wait for the server to confirm (see declareExchange())
+     *
+     *  The nowait flag is ignored for queues without a name, because the name
+     *  that is assigned by the server is sent in the answer. With the nowait
+     *  flag the message count and consumer count are reported as zero.
      *
      *  @param  name        name of the queue
      *  @param  flags       combination of flags
@@ -257,16 +309,22 @@ public:
     /**
      *  Bind a queue to an exchange
      *
+     *  The following flags can be used:
+     *
+     *      -   nowait      do not wait for the server to confirm (see declareExchange())
+     *
      *  @param  exchange    the source exchange
      *  @param  queue       the target queue
      *  @param  routingkey  the routing key
+     *  @param  flags       optional flags
      *  @param  arguments   additional bind arguments
      *
      *  This function returns a deferred handler. Callbacks can be installed
      *  using onSuccess(), onError() and onFinalize() methods.
      */
-    Deferred &bindQueue(const std::string &exchange, const std::string &queue, const std::string &routingkey, const Table &arguments) { return _implementation->bindQueue(exchange, queue, routingkey, arguments); }
-    Deferred &bindQueue(const std::string &exchange, const std::string &queue, const std::string &routingkey) { return _implementation->bindQueue(exchange, queue, routingkey, Table()); }
+    Deferred &bindQueue(const std::string &exchange, const std::string &queue, const std::string &routingkey, int flags, const Table &arguments) { return _implementation->bindQueue(exchange, queue, routingkey, flags, arguments); }
+    Deferred &bindQueue(const std::string &exchange, const std::string &queue, const std::string &routingkey, const Table &arguments) { return _implementation->bindQueue(exchange, queue, routingkey, 0, arguments); }
+    Deferred &bindQueue(const std::string &exchange, const std::string &queue, const std::string &routingkey, int flags = 0) { return _implementation->bindQueue(exchange, queue, routingkey, flags, Table()); }
 
     /**
      *  Unbind a queue from an exchange
@@ -330,6 +388,9 @@ public:
     /**
      *  Publish a message to an exchange
      *
+     *  The body is copied into the output right away, so the data does not
+     *  have to stay valid after publish() returns.
+     *
      *  @param  exchange    the exchange to publish to
      *  @param  routingkey  the routing key
      *  @param  envelope    the full envelope to send
@@ -337,10 +398,56 @@ public:
      *  @param  size        size of the message
      */
     bool publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope) { return _implementation->publish(exchange, routingKey, envelope); }
-    bool publish(const std::string &exchange, const std::string &routingKey, const std::string &message) { return _implementation->publish(exchange, routingKey, Envelope(message)); }
+    bool publish(const std::string &exchange, const std::string &routingKey, const std::string &message) { return _implementation->publish(exchange, routingKey, Envelope(message.data(), message.size())); }
     bool publish(const std::string &exchange, const std::string &routingKey, const char *message, size_t size) { return _implementation->publish(exchange, routingKey, Envelope(message, size)); }
     bool publish(const std::string &exchange, const std::string &routingKey, const char *message) { return _implementation->publish(exchange, routingKey, Envelope(message, strlen(message))); }
 
+    /**
+     *  Publish a message that was received, to another exchange or with
+     *  another routing key, on this or on another connection
+     *
+     *  As long as none of the properties were accessed, they are sent as they
+     *  were received, without decoding and encoding them. The body is sent
+     *  from the frames in which it was received (see Message::segments()),
+     *  so it is not reassembled. Call this inside the callback that received
+     *  the message, or with a message that was taken over by an OwnedMessage.
+     *  Messages for streaming consumers can not be republished, because the
+     *  body is not stored in them.
+     *
+     *  @param  exchange    the exchange to publish to
+     *  @param  routingkey  the routing key
+     *  @param  message     the received message
+     *  @return bool
+     */
+    bool republish(const std::string &exchange, const std::string &routingKey, const Message &message) { return _implementation->republish(exchange, routingKey, message); }
+
+    /**
+     *  Publish a message without holding its body in memory
+     *
+     *  The publish and header frames are sent right away, but the body is read
+     *  frame by frame, either with a callback or from a file descriptor, when
+     *  Connection::pump() is called. In the meantime, all other frames on this
+     *  channel wait, so use a channel of its own for a big upload.
+     *
+     *  The callback should have the signature
+     *
+     *      size_t myReader(char *buffer, size_t size);
+     *
+     *  and return the number of bytes that were written into the buffer. A message
+     *  can not be aborted once it was started: if the callback returns zero (or the
+     *  file could not be read) before the full body was read, the channel ends up
+     *  in an error state and the connection is closed.
+     *
+     *  @param  exchange    the exchange to publish to
+     *  @param  routingkey  the routing key
+     *  @param  envelope    the envelope with the meta data (its body is not used)
+     *  @param  size        size of the body
+     *  @param  reader      callback to read the body
+     *  @param  fd          file descriptor to read the body from
+     */
+    bool publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope, uint64_t size, const ReadCallback &reader) { return _implementation->publish(exchange, routingKey, envelope, size, reader); }
+    bool publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope, uint64_t size, int fd) { return _implementation->publish(exchange, routingKey, envelope, size, fd); }
+
     /**
      *  Set the Quality of Service (QOS) for this channel
      *
@@ -353,6 +460,9 @@ public:
      *  @param  prefetchCount       maximum number of messages to prefetch
      *  @param  global              share counter between all consumers on the same channel
      *  @return bool                whether the Qos frame is sent.
+     *
+     *  There is no nowait variant, because the protocol always confirms this
+     *  instruction. It should normally be sent only once, before consuming.
      */
     Deferred &setQos(uint16_t prefetchCount, bool global = false)
     {
@@ -373,6 +483,10 @@ public:
      *      -   nolocal             if set, messages published on this channel are not also consumed
      *      -   noack               if set, consumed messages do not have to be acked, this happens automatically
      *      -   exclusive           request exclusive access, only this consumer can access the queue
+     *      -   nowait              do not wait for the server to confirm (see declareExchange())
+     *
+     *  The nowait flag is ignored if no consumer tag is given, because the tag
+     *  that is assigned by the server is sent in the answer.
      *
      *  @param  queue               the queue from which you want to consume
      *  @param  tag                 a consumer tag that will be associated with this consume operation
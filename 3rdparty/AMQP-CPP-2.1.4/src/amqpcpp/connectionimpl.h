@@ -51,6 +51,12 @@ protected:
      */
     bool _closed = false;
 
+    /**
+     *  Has the server blocked the connection?
+     *  @var    bool
+     */
+    bool _blocked = false;
+
     /**
      *  All channels that are active
      *  @var    map
@@ -93,6 +99,13 @@ protected:
      */
     std::queue<OutBuffer> _queue;
 
+    /**
+     *  Pool for the buffers of message bodies that span multiple frames, it
+     *  is shared with the messages, so that it outlives the connection
+     *  @var    std::shared_ptr<BufferPool>
+     */
+    std::shared_ptr<BufferPool> _pool = std::make_shared<BufferPool>();
+
     /**
      *  Helper method to send the close frame
      *  Return value tells if the connection is still valid
@@ -106,6 +119,18 @@ protected:
      */
     bool waiting() const;
 
+    /**
+     *  Make sure that messages that are not yet complete no longer refer
+     *  to the buffer that was passed to parse()
+     */
+    void preserve();
+
+    /**
+     *  Report the messages that were collected for batch consumers
+     *  @return bool        does the connection still exist?
+     */
+    bool reportBatches();
+
 
 private:
     /**
@@ -255,6 +280,13 @@ public:
      */
     size_t parse(const Buffer &buffer);
 
+    /**
+     *  Send the next part of the bodies of streaming publishes
+     *  @param  max         number of bytes to send (at least one frame is sent)
+     *  @return size_t      number of bytes sent
+     */
+    size_t pump(size_t max);
+
     /**
      *  Close the connection
      *  This will close all channels
@@ -333,6 +365,57 @@ public:
         _handler->onClosed(_parent);
     }
 
+    /**
+     *  Report the messages that were collected for batch consumers on a channel,
+     *  this is done before anything else is processed on the channel
+     *  @param  id          the channel identifier
+     *  @return bool        does the connection still exist?
+     */
+    bool reportBatch(uint16_t id);
+
+    /**
+     *  Report that the server blocked the connection
+     *  @param  reason
+     */
+    void reportBlocked(const char *reason)
+    {
+        // publishing is no longer possible
+        _blocked = true;
+
+        // inform the handler
+        _handler->onBlocked(_parent, reason);
+    }
+
+    /**
+     *  Report that the server unblocked the connection
+     */
+    void reportUnblocked()
+    {
+        // publishing is possible again
+        _blocked = false;
+
+        // inform the handler
+        _handler->onUnblocked(_parent);
+    }
+
+    /**
+     *  Is the connection blocked by the server?
+     *  @return bool
+     */
+    bool blocked() const
+    {
+        return _blocked;
+    }
+
+    /**
+     *  The pool for the buffers of message bodies that span multiple frames
+     *  @return std::shared_ptr<BufferPool>
+     */
+    const std::shared_ptr<BufferPool> &pool() const
+    {
+        return _pool;
+    }
+
     /**
      *  The actual connection is a friend and can construct this class
      */
@@ -74,6 +74,19 @@ public:
         _number = frame.nextUint32();
     }
     
+    /**
+     *  Copy constructor
+     *
+     *  This is declared because the class has an assignment operator, the
+     *  implicit copy constructor is deprecated in that case
+     *
+     *  @param  that
+     */
+    DecimalField(const DecimalField &that) noexcept :
+        _places(that._places),
+        _number(that._number)
+    {}
+
     /**
      *  Destructor
      */
@@ -88,6 +101,27 @@ public:
         return std::make_shared<DecimalField>(_places, _number);
     }
 
+    /**
+     *  Create a copy of this object in a buffer
+     *  @param  buffer
+     *  @param  size
+     *  @return Field*
+     */
+    virtual Field *copy(void *buffer, size_t size) const override
+    {
+        return Field::copy(*this, buffer, size);
+    }
+
+    /**
+     *  Move this object into a buffer
+     *  @param  buffer
+     *  @return Field*
+     */
+    virtual Field *move(void *buffer) noexcept override
+    {
+        return Field::move(*this, buffer);
+    }
+
     /**
      *  Output the object to a stream
      *  @param std::ostream
@@ -53,6 +53,13 @@ protected:
      */
     bool _failed;
 
+    /**
+     *  Was the operation sent with the nowait option? The server does not
+     *  answer, so we report success as soon as callbacks are installed
+     *  @var bool
+     */
+    bool _nowait = false;
+
 
     /**
      *  The next deferred object
@@ -197,6 +204,9 @@ public:
         // store callback
         _successCallback = callback;
 
+        // if the server does not answer, we call the callback right away
+        if (_nowait && !_failed && callback) callback();
+
         // allow chaining
         return *this;
     }
@@ -217,7 +227,7 @@ public:
         _errorCallback = callback;
 
         // if the object is already in a failed state, we call the callback right away
-        if (_failed) callback("Frame could not be sent");
+        if (_failed && callback) callback("Frame could not be sent");
 
         // allow chaining
         return *this;
@@ -0,0 +1,185 @@
+#pragma once
+/**
+ *  DeferredPool.h
+ *
+ *  Every channel has a pool of memory for its deferred objects. A deferred
+ *  object is created for every synchronous operation, and is destructed as
+ *  soon as the server has answered. Instead of giving the memory back, it is
+ *  kept in the pool, and it is used again for the next operation.
+ *
+ *  The pool is shared by the channel and the allocator of every deferred
+ *  object, so that it stays alive until the last deferred is gone.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class DeferredPool
+{
+private:
+    /**
+     *  Blocks of memory that are not in use, grouped by size. There are
+     *  only a couple of different deferred classes, so there are only a
+     *  couple of different sizes
+     *  @var std::vector
+     */
+    std::vector<std::pair<size_t, std::vector<void*>>> _blocks;
+
+    /**
+     *  Maximum number of unused blocks of a single size that are kept
+     *  @var size_t
+     */
+    static const size_t limit = 1024;
+
+    /**
+     *  Find the unused blocks for a certain size
+     *  @param  size
+     *  @return std::vector
+     */
+    std::vector<void*> &blocks(size_t size)
+    {
+        // look for the size
+        for (auto &blocks : _blocks) if (blocks.first == size) return blocks.second;
+
+        // this is a new size
+        _blocks.emplace_back(size, std::vector<void*>());
+        return _blocks.back().second;
+    }
+
+public:
+    /**
+     *  Constructor
+     */
+    DeferredPool() {}
+
+    /**
+     *  The pool can not be copied
+     *  @param  that
+     */
+    DeferredPool(const DeferredPool &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~DeferredPool()
+    {
+        // give back all memory that is not in use
+        for (auto &blocks : _blocks) for (auto block : blocks.second) ::operator delete(block);
+    }
+
+    /**
+     *  Allocate a block of memory
+     *  @param  size
+     *  @return void*
+     */
+    void *allocate(size_t size)
+    {
+        // find the unused blocks of this size
+        auto &unused = blocks(size);
+
+        // allocate new memory if there are none
+        if (unused.empty()) return ::operator new(size);
+
+        // reuse the last block
+        void *result = unused.back();
+        unused.pop_back();
+        return result;
+    }
+
+    /**
+     *  Give back a block of memory
+     *  @param  block
+     *  @param  size
+     */
+    void deallocate(void *block, size_t size)
+    {
+        // find the unused blocks of this size
+        auto &unused = blocks(size);
+
+        // keep the block, unless we already have enough of them
+        if (unused.size() < limit) unused.push_back(block);
+        else ::operator delete(block);
+    }
+};
+
+/**
+ *  Allocator that takes its memory from a pool, for use with std::allocate_shared
+ */
+template <typename T>
+class DeferredAllocator
+{
+private:
+    /**
+     *  The pool
+     *  @var DeferredPool
+     */
+    std::shared_ptr<DeferredPool> _pool;
+
+    /**
+     *  Allocators of other types may access the pool
+     */
+    template <typename U>
+    friend class DeferredAllocator;
+
+public:
+    /**
+     *  The type that is allocated
+     *  @typedef
+     */
+    typedef T value_type;
+
+    /**
+     *  Constructor
+     *  @param  pool
+     */
+    DeferredAllocator(const std::shared_ptr<DeferredPool> &pool) : _pool(pool) {}
+
+    /**
+     *  Constructor from an allocator for a different type
+     *  @param  that
+     */
+    template <typename U>
+    DeferredAllocator(const DeferredAllocator<U> &that) : _pool(that._pool) {}
+
+    /**
+     *  Allocate memory
+     *  @param  n       number of objects
+     *  @return T*
+     */
+    T *allocate(size_t n)
+    {
+        return static_cast<T*>(_pool->allocate(n * sizeof(T)));
+    }
+
+    /**
+     *  Give back memory
+     *  @param  p       the memory
+     *  @param  n       number of objects
+     */
+    void deallocate(T *p, size_t n)
+    {
+        _pool->deallocate(p, n * sizeof(T));
+    }
+
+    /**
+     *  Compare allocators
+     *  @param  that
+     *  @return bool
+     */
+    template <typename U>
+    bool operator==(const DeferredAllocator<U> &that) const { return _pool == that._pool; }
+    template <typename U>
+    bool operator!=(const DeferredAllocator<U> &that) const { return _pool != that._pool; }
+};
+
+/**
+ *  End namespace
+ */
+}
@@ -0,0 +1,159 @@
+#pragma once
+/**
+ *  EncodedTable.h
+ *
+ *  A table that can no longer be changed, and that is encoded only once.
+ *  Use it for arguments and headers that are sent over and over again, like
+ *  the arguments of a queue declaration, or the static headers of a
+ *  publisher. It can be passed to every method that accepts a table.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class EncodedTable : public Table
+{
+private:
+    /**
+     *  The encoded table, including the leading size
+     *  @var std::string
+     */
+    std::string _data;
+
+    /**
+     *  Encode the table
+     */
+    void encode()
+    {
+        // encode the table into a buffer
+        OutBuffer buffer(Table::size());
+        Table::fill(buffer);
+
+        // and store the result
+        _data.assign(buffer.data(), buffer.size());
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  table   the table to encode
+     */
+    EncodedTable(const Table &table) : Table(table)
+    {
+        // encode the table right away
+        encode();
+    }
+
+    /**
+     *  Constructor
+     *  @param  table   the table to encode
+     */
+    EncodedTable(Table &&table) : Table(std::move(table))
+    {
+        // encode the table right away
+        encode();
+    }
+
+    /**
+     *  Copy constructor
+     *  @param  that
+     */
+    EncodedTable(const EncodedTable &that) : Table(that), _data(that._data) {}
+
+    /**
+     *  Move constructor
+     *  @param  that
+     */
+    EncodedTable(EncodedTable &&that) noexcept : Table(std::move(that)), _data(std::move(that._data)) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~EncodedTable() {}
+
+    /**
+     *  The table can not be changed
+     */
+    Table &set(const StringView &name, const Field &value) = delete;
+
+    /**
+     *  Get a const field (this hides the non-const versions of the table)
+     *
+     *  @param  name    field name
+     */
+    const Field &operator[](const std::string& name) const
+    {
+        return get(name);
+    }
+
+    /**
+     *  Get a const field (this hides the non-const versions of the table)
+     *
+     *  @param  name    field name
+     */
+    const Field &operator[](const char *name) const
+    {
+        return get(name);
+    }
+
+    /**
+     *  Create a new instance on the heap of this object, identical to the object passed
+     *  @return Field*
+     */
+    virtual std::shared_ptr<Field> clone() const override
+    {
+        return std::make_shared<EncodedTable>(*this);
+    }
+
+    /**
+     *  Create a copy of this object in a buffer
+     *  @param  buffer
+     *  @param  size
+     *  @return Field*
+     */
+    virtual Field *copy(void *buffer, size_t size) const override
+    {
+        return Field::copy(*this, buffer, size);
+    }
+
+    /**
+     *  Move this object into a buffer
+     *  @param  buffer
+     *  @return Field*
+     */
+    virtual Field *move(void *buffer) noexcept override
+    {
+        return Field::move(*this, buffer);
+    }
+
+    /**
+     *  Get the size this field will take when
+     *  encoded in the AMQP wire-frame format
+     *  @return size_t
+     */
+    virtual size_t size() const override
+    {
+        return _data.size();
+    }
+
+    /**
+     *  Write encoded payload to the given buffer.
+     *  @param  buffer
+     */
+    virtual void fill(OutBuffer& buffer) const override
+    {
+        buffer.add(_data.data(), _data.size());
+    }
+};
+
+/**
+ *  end namespace
+ */
+}
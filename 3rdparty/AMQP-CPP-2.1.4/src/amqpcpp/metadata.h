@@ -5,6 +5,22 @@
  *  With every published message a set of meta data is passed to. This class
  *  holds all that meta data.
  *
+ *  To keep envelopes and messages small, only the properties that are present
+ *  are stored. The string properties are packed into a single buffer, in the
+ *  same format and order as they appear on the wire, and that buffer lives
+ *  inside the object unless the strings are too big to fit.
+ *
+ *  Meta data of received messages is not decoded right away: the raw bytes
+ *  from the header frame are stored in the string buffer, and are only
+ *  decoded when one of the properties is accessed for the first time. That
+ *  is why most members are mutable. Even then the header table is kept in
+ *  its encoded form, right after the strings, so that it can be inspected
+ *  with a TableView; it is only turned into a Table when headers() is called.
+ *
+ *  Because of this, reading a meta data object is not thread safe, even
+ *  through a const reference. Messages that are taken over with an
+ *  OwnedMessage are decoded right away, see OwnedMessage for the details.
+ *
  *  @copyright 2014 Copernica BV
  */
 
@@ -20,139 +36,411 @@ class MetaData
 {
 protected:
     /**
-     *  First set of booleans
-     *  @var    BooleanSet
+     *  The presence flags, the bits are in the same order as on the wire
      */
-    BooleanSet _bools1;
-    
+    enum : uint16_t {
+        flag_contentType        =   0x8000,
+        flag_contentEncoding    =   0x4000,
+        flag_headers            =   0x2000,
+        flag_deliveryMode       =   0x1000,
+        flag_priority           =   0x0800,
+        flag_correlationID      =   0x0400,
+        flag_replyTo            =   0x0200,
+        flag_expiration         =   0x0100,
+        flag_messageID          =   0x0080,
+        flag_timestamp          =   0x0040,
+        flag_typeName           =   0x0020,
+        flag_userID             =   0x0010,
+        flag_appID              =   0x0008,
+        flag_clusterID          =   0x0004,
+        flag_all                =   0xfffc,
+        flag_strings            =   0xc7bc
+    };
+
     /**
-     *  Second set of booleans
-     *  @var    BooleanSet
+     *  Message header field table (only allocated when the headers are set)
+     *  @var    Table
      */
-    BooleanSet _bools2;
-    
+    mutable Table *_headers = nullptr;
+
     /**
-     *  MIME content type
-     *  @var    ShortString
+     *  Copies of the string properties, for the accessors that return a
+     *  std::string (only allocated when one of those is used)
+     *  @var    std::string
      */
-    ShortString _contentType;
+    mutable std::string *_copies = nullptr;
 
     /**
-     *  MIME content encoding
-     *  @var    ShortString
+     *  Message timestamp
+     *  @var    uint64_t
      */
-    ShortString _contentEncoding;
+    mutable uint64_t _timestamp = 0;
 
     /**
-     *  message header field table
-     *  @var    Table
+     *  Number of bytes in use in the string buffer
+     *  @var    uint32_t
      */
-    Table _headers;
+    mutable uint32_t _size = 0;
+
+    /**
+     *  Number of bytes of the encoded header table that follows the strings
+     *  @var    uint32_t
+     */
+    mutable uint32_t _table = 0;
+
+    /**
+     *  Capacity of the string buffer
+     *  @var    uint32_t
+     */
+    mutable uint32_t _capacity = sizeof(_strings.local);
+
+    /**
+     *  Which properties are present?
+     *  @var    uint16_t
+     */
+    mutable uint16_t _flags = 0;
 
     /**
      *  Delivery mode (non-persistent (1) or persistent (2))
-     *  @var    UOctet
+     *  @var    uint8_t
      */
-    UOctet _deliveryMode = 0;
+    mutable uint8_t _deliveryMode = 0;
 
     /**
-     *  boolean whether field was sent to us
-     *  @var    UOctet
+     *  Message priority
+     *  @var    uint8_t
      */
-    UOctet _priority = 0;
+    mutable uint8_t _priority = 0;
 
     /**
-     *  application correlation identifier
-     *  @var    ShortString
+     *  Does the string buffer still hold the raw, undecoded properties?
+     *  @var    bool
      */
-    ShortString _correlationID;
+    mutable bool _encoded = false;
 
     /**
-     *  address to reply to
-     *  @var    ShortString
+     *  The string properties, stored as a one-byte size followed by the
+     *  characters, in the order of the presence flags. Small sets of strings
+     *  are stored inside the object, bigger sets on the heap.
+     *  @var    union
      */
-    ShortString _replyTo;
+    mutable union {
+        char local[32];
+        char *heap;
+    } _strings;
+
 
     /**
-     *  message expiration identifier
-     *  @var    ShortString
+     *  Protected constructor to ensure that this class can only be constructed
+     *  in a derived class
      */
-    ShortString _expiration;
+    MetaData() {}
 
     /**
-     *  application message identifier
-     *  @var    ShortString
+     *  Store the raw properties of a received header frame, they are only
+     *  decoded when they are accessed
+     *
+     *  The properties should have been checked with valid(), so that the
+     *  accessors can decode them without running into errors.
+     *
+     *  @param  flags       the presence flags
+     *  @param  properties  the encoded properties that follow the flags
      */
-    ShortString _messageID;
+    void setEncoded(uint16_t flags, const StringView &properties)
+    {
+        // forget the current headers
+        if (_headers) delete _headers;
+        _headers = nullptr;
+
+        // forget the scalars of the previous message, decode() only sets
+        // the ones that are present
+        _deliveryMode = _priority = 0;
+        _timestamp = 0;
+
+        // copy the raw bytes (there is no need to preserve the current strings)
+        _size = _table = 0;
+        reserve(properties.size());
+        memcpy(strings(), properties.data(), properties.size());
+
+        // store the flags and the size
+        _flags = flags & flag_all;
+        _size = properties.size();
+        _encoded = true;
+    }
 
     /**
-     *  message timestamp
-     *  @var    Timestamp
+     *  Decode the raw properties, if that did not yet happen
+     *  (derived classes use this to decode received properties up front)
      */
-    Timestamp _timestamp;
+    void decode() const
+    {
+        // leap out if already decoded
+        if (!_encoded) return;
+
+        // the raw properties are decoded in place: the strings and the
+        // table stay where they are, only the other properties in between
+        // are removed
+        char *data = strings();
+        ByteBuffer buffer(data, _size);
+        ReceivedFrame frame(buffer);
+        uint32_t size = 0;
+        uint32_t table = 0;
+
+        // the raw data is no longer valid once we start
+        _encoded = false;
+
+        // process the properties in wire order (they were checked with
+        // valid() when the header frame was received, so this does not fail)
+        for (uint16_t bit = 0x8000; bit & flag_all; bit >>= 1)
+        {
+            // skip properties that are not set
+            if (!(_flags & bit)) continue;
+
+            // the scalar properties
+            if (bit == flag_deliveryMode)       _deliveryMode = frame.nextUint8();
+            else if (bit == flag_priority)      _priority = frame.nextUint8();
+            else if (bit == flag_timestamp)     _timestamp = frame.nextUint64();
+            else if (bit == flag_headers)
+            {
+                // move the table (size included) to the front, and remember where it is
+                uint32_t length = frame.nextUint32();
+                memmove(data + size, frame.nextData(length) - 4, 4 + length);
+                table = 4 + length;
+                size += table;
+            }
+            else
+            {
+                // move the string (size byte included) to the front
+                StringView value = frame.nextShortString();
+                memmove(data + size, value.data() - 1, 1 + value.size());
+                size += 1 + value.size();
+            }
+        }
 
+        // the table comes after the contentType and contentEncoding, move
+        // it behind the other strings
+        if (table > 0)
+        {
+            size_t pos = offset(flag_headers);
+            std::rotate(data + pos, data + pos + table, data + size);
+        }
+
+        // the buffer now holds the strings, followed by the table
+        _size = size - table;
+        _table = table;
+    }
+
+private:
     /**
-     *  message type name
-     *  @var    ShortString
+     *  Pointer to the string buffer
+     *  @return char*
      */
-    ShortString _typeName;
+    char *strings() const
+    {
+        return _capacity > sizeof(_strings.local) ? _strings.heap : _strings.local;
+    }
 
     /**
-     *  creating user id
-     *  @var    ShortString
+     *  Make sure that the string buffer can hold a certain number of bytes
+     *  @param  size
      */
-    ShortString _userID;
+    void reserve(size_t size) const
+    {
+        // leap out if it already fits
+        if (size <= _capacity) return;
+
+        // allocate a new buffer, at least twice as big
+        size_t capacity = std::max(size, (size_t)_capacity * 2);
+        char *buffer = new char[capacity];
+
+        // copy the current strings and table
+        memcpy(buffer, strings(), _size + _table);
+
+        // free the old buffer
+        if (_capacity > sizeof(_strings.local)) delete[] _strings.heap;
+
+        // store the new buffer
+        _strings.heap = buffer;
+        _capacity = capacity;
+    }
 
     /**
-     *  creating application id
-     *  @var    ShortString
+     *  Offset in the string buffer where a certain property starts
+     *  @param  flag
+     *  @return size_t
      */
-    ShortString _appID;
+    size_t offset(uint16_t flag) const
+    {
+        // the string buffer
+        const char *data = strings();
+        size_t pos = 0;
+
+        // skip over all string properties that come before it
+        for (uint16_t bit = 0x8000; bit > flag; bit >>= 1)
+        {
+            // skip the size byte and the characters
+            if (_flags & bit & flag_strings) pos += 1 + (uint8_t)data[pos];
+        }
+
+        // done
+        return pos;
+    }
 
     /**
-     *  Deprecated cluster ID
-     *  @var    ShortString
+     *  Append a string property to the end of the string buffer
+     *  This is only valid when properties are added in wire order
+     *  @param  value
      */
-    ShortString _clusterID;
+    void append(const StringView &value)
+    {
+        // strings are limited to 255 characters
+        uint8_t size = std::min(value.size(), (size_t)255);
+
+        // make sure it fits
+        reserve(_size + 1 + size);
 
+        // write the size and the characters
+        char *data = strings() + _size;
+        data[0] = size;
+        memcpy(data + 1, value.data(), size);
+
+        // the buffer is bigger now
+        _size += 1 + size;
+    }
 
     /**
-     *  Protected constructor to ensure that this class can only be constructed
-     *  in a derived class
+     *  Get a string property
+     *  @param  flag
+     *  @return StringView
      */
-    MetaData() {}
-    
-    
+    StringView get(uint16_t flag) const
+    {
+        // make sure the properties are decoded
+        decode();
+
+        // leap out if the property is not set
+        if (!(_flags & flag)) return StringView();
+
+        // find the property
+        const char *data = strings() + offset(flag);
+
+        // the first byte holds the size
+        return StringView(data + 1, (uint8_t)data[0]);
+    }
+
+    /**
+     *  Get a string property as a std::string
+     *  @param  flag
+     *  @return std::string
+     */
+    const std::string &string(uint16_t flag) const
+    {
+        // allocate the copies when they are first needed
+        if (!_copies) _copies = new std::string[16];
+
+        // every property has its own copy, at the position of its flag
+        size_t index = 0;
+        while ((0x8000 >> index) != flag) index++;
+
+        // copy the current value (this reuses the capacity of the string)
+        StringView value = get(flag);
+        return _copies[index].assign(value.data(), value.size());
+    }
+
+    /**
+     *  Set a string property
+     *  @param  flag
+     *  @param  value
+     */
+    void set(uint16_t flag, const StringView &value)
+    {
+        // make sure the properties are decoded
+        decode();
+
+        // if the value is stored in our own buffer, we first need a copy
+        if (value.data() >= strings() && value.data() < strings() + _capacity) return set(flag, StringView(value.str()));
+
+        // strings are limited to 255 characters
+        uint8_t size = std::min(value.size(), (size_t)255);
+
+        // where does the property start, and how many bytes does it now use?
+        size_t pos = offset(flag);
+        size_t oldsize = (_flags & flag) ? 1 + (uint8_t)strings()[pos] : 0;
+
+        // make sure the new value fits
+        reserve(_size + _table - oldsize + 1 + size);
+
+        // move the properties that come after it, and the table
+        char *data = strings();
+        memmove(data + pos + 1 + size, data + pos + oldsize, _size + _table - pos - oldsize);
+
+        // write the size and the characters
+        data[pos] = size;
+        memcpy(data + pos + 1, value.data(), size);
+
+        // update the size and the flags
+        _size = _size - oldsize + 1 + size;
+        _flags |= flag;
+    }
+
 public:
     /**
      *  Read incoming frame
      *  @param  frame
      */
-    MetaData(ReceivedFrame &frame) :
-        _bools1(frame),
-        _bools2(frame)
+    MetaData(ReceivedFrame &frame) : _flags(frame.nextUint16() & flag_all)
     {
         // only copy the properties that were sent
-        if (hasContentType())       _contentType = ShortString(frame);
-        if (hasContentEncoding())   _contentEncoding = ShortString(frame);
-        if (hasHeaders())           _headers = Table(frame);
-        if (hasDeliveryMode())      _deliveryMode = UOctet(frame);
-        if (hasPriority())          _priority = UOctet(frame);
-        if (hasCorrelationID())     _correlationID = ShortString(frame);
-        if (hasReplyTo())           _replyTo = ShortString(frame);
-        if (hasExpiration())        _expiration = ShortString(frame);
-        if (hasMessageID())         _messageID = ShortString(frame);
-        if (hasTimestamp())         _timestamp = Timestamp(frame);
-        if (hasTypeName())          _typeName = ShortString(frame);
-        if (hasUserID())            _userID = ShortString(frame);
-        if (hasAppID())             _appID = ShortString(frame);
-        if (hasClusterID())         _clusterID = ShortString(frame);
+        if (hasContentType())       append(frame.nextShortString());
+        if (hasContentEncoding())   append(frame.nextShortString());
+        if (hasHeaders())           _headers = new Table(frame);
+        if (hasDeliveryMode())      _deliveryMode = frame.nextUint8();
+        if (hasPriority())          _priority = frame.nextUint8();
+        if (hasCorrelationID())     append(frame.nextShortString());
+        if (hasReplyTo())           append(frame.nextShortString());
+        if (hasExpiration())        append(frame.nextShortString());
+        if (hasMessageID())         append(frame.nextShortString());
+        if (hasTimestamp())         _timestamp = frame.nextUint64();
+        if (hasTypeName())          append(frame.nextShortString());
+        if (hasUserID())            append(frame.nextShortString());
+        if (hasAppID())             append(frame.nextShortString());
+        if (hasClusterID())         append(frame.nextShortString());
+    }
+
+    /**
+     *  Copy constructor
+     *  @param  that
+     */
+    MetaData(const MetaData &that)
+    {
+        // copy all fields
+        set(that);
     }
 
     /**
      *  Destructor
      */
-    virtual ~MetaData() {}
+    virtual ~MetaData()
+    {
+        // free the headers, the strings and the copies
+        if (_headers) delete _headers;
+        if (_capacity > sizeof(_strings.local)) delete[] _strings.heap;
+        if (_copies) delete[] _copies;
+    }
+
+    /**
+     *  Assignment operator
+     *  @param  that
+     *  @return MetaData
+     */
+    MetaData &operator=(const MetaData &that)
+    {
+        // copy all fields
+        set(that);
+
+        // allow chaining
+        return *this;
+    }
 
     /**
      *  Set all meta data
@@ -160,108 +448,254 @@ public:
      */
     void set(const MetaData &data)
     {
-        // simply copy all fields
-        _bools1 = data._bools1;
-        _bools2 = data._bools2;
-        _contentType = data._contentType;
-        _contentEncoding = data._contentEncoding;
-        _headers = data._headers;
+        // skip self assignment
+        if (this == &data) return;
+
+        // copy the scalar fields
+        _flags = data._flags;
         _deliveryMode = data._deliveryMode;
         _priority = data._priority;
-        _correlationID = data._correlationID;
-        _replyTo = data._replyTo;
-        _expiration = data._expiration;
-        _messageID = data._messageID;
         _timestamp = data._timestamp;
-        _typeName = data._typeName;
-        _userID = data._userID;
-        _appID = data._appID;
-        _clusterID = data._clusterID;
+        _encoded = data._encoded;
+
+        // copy the headers (this keeps the type, an encoded table stays encoded)
+        if (_headers) delete _headers;
+        _headers = data._headers ? static_cast<Table *>(data._headers->copy(nullptr, 0)) : nullptr;
+
+        // copy the strings and table, or the raw properties (this reuses our current buffer if it is big enough)
+        _size = _table = 0;
+        reserve(data._size + data._table);
+        memcpy(strings(), data.strings(), data._size + data._table);
+        _size = data._size;
+        _table = data._table;
+    }
+
+    /**
+     *  Check the raw properties of a received header frame
+     *
+     *  The properties of received messages are decoded when they are first
+     *  accessed, possibly in another thread. The header frame therefore
+     *  checks them up front, so that decoding them later can not fail.
+     *
+     *  @param  flags       the presence flags
+     *  @param  properties  the encoded properties that follow the flags
+     *  @return bool
+     */
+    static bool valid(uint16_t flags, const StringView &properties)
+    {
+        // walk over the raw data
+        ByteBuffer buffer(properties.data(), properties.size());
+        ReceivedFrame frame(buffer);
+
+        try
+        {
+            // process the properties in wire order
+            for (uint16_t bit = 0x8000; bit & flag_all; bit >>= 1)
+            {
+                // skip properties that are not set
+                if (!(flags & bit)) continue;
+
+                // the scalars, the header table, and the strings should fit
+                if (bit == flag_deliveryMode || bit == flag_priority) frame.nextUint8();
+                else if (bit == flag_timestamp) frame.nextUint64();
+                else if (bit == flag_headers && !TableView(frame).valid()) return false;
+                else if (bit != flag_headers) frame.nextShortString();
+            }
+
+            // all properties fit
+            return true;
+        }
+        catch (...)
+        {
+            // the data was too short
+            return false;
+        }
     }
 
     /**
      *  Check if a certain field is set
      *  @return bool
      */
-    bool hasExpiration      () const { return _bools1.get(0); }
-    bool hasReplyTo         () const { return _bools1.get(1); }
-    bool hasCorrelationID   () const { return _bools1.get(2); }
-    bool hasPriority        () const { return _bools1.get(3); }
-    bool hasDeliveryMode    () const { return _bools1.get(4); }
-    bool hasHeaders         () const { return _bools1.get(5); }
-    bool hasContentEncoding () const { return _bools1.get(6); }
-    bool hasContentType     () const { return _bools1.get(7); }
-    bool hasClusterID       () const { return _bools2.get(2); }
-    bool hasAppID           () const { return _bools2.get(3); }
-    bool hasUserID          () const { return _bools2.get(4); }
-    bool hasTypeName        () const { return _bools2.get(5); }
-    bool hasTimestamp       () const { return _bools2.get(6); }
-    bool hasMessageID       () const { return _bools2.get(7); }
+    bool hasExpiration      () const { return _flags & flag_expiration;     }
+    bool hasReplyTo         () const { return _flags & flag_replyTo;        }
+    bool hasCorrelationID   () const { return _flags & flag_correlationID;  }
+    bool hasPriority        () const { return _flags & flag_priority;       }
+    bool hasDeliveryMode    () const { return _flags & flag_deliveryMode;   }
+    bool hasHeaders         () const { return _flags & flag_headers;        }
+    bool hasContentEncoding () const { return _flags & flag_contentEncoding;}
+    bool hasContentType     () const { return _flags & flag_contentType;    }
+    bool hasClusterID       () const { return _flags & flag_clusterID;      }
+    bool hasAppID           () const { return _flags & flag_appID;          }
+    bool hasUserID          () const { return _flags & flag_userID;         }
+    bool hasTypeName        () const { return _flags & flag_typeName;       }
+    bool hasTimestamp       () const { return _flags & flag_timestamp;      }
+    bool hasMessageID       () const { return _flags & flag_messageID;      }
 
     /**
      *  Set the various supported fields
      *  @param  value
      */
-    void setExpiration      (const std::string &value) { _expiration        = value; _bools1.set(0,true); }
-    void setReplyTo         (const std::string &value) { _replyTo           = value; _bools1.set(1,true); }
-    void setCorrelationID   (const std::string &value) { _correlationID     = value; _bools1.set(2,true); }
-    void setPriority        (uint8_t value)            { _priority          = value; _bools1.set(3,true); }
-    void setDeliveryMode    (uint8_t value)            { _deliveryMode      = value; _bools1.set(4,true); }
-    void setHeaders         (const Table &value)       { _headers           = value; _bools1.set(5,true); }
-    void setContentEncoding (const std::string &value) { _contentEncoding   = value; _bools1.set(6,true); }
-    void setContentType     (const std::string &value) { _contentType       = value; _bools1.set(7,true); }
-    void setClusterID       (const std::string &value) { _clusterID         = value; _bools2.set(2,true); }
-    void setAppID           (const std::string &value) { _appID             = value; _bools2.set(3,true); }
-    void setUserID          (const std::string &value) { _userID            = value; _bools2.set(4,true); }
-    void setTypeName        (const std::string &value) { _typeName          = value; _bools2.set(5,true); }
-    void setTimestamp       (uint64_t value)           { _timestamp         = value; _bools2.set(6,true); }
-    void setMessageID       (const std::string &value) { _messageID         = value; _bools2.set(7,true); }
+    void setExpiration      (const StringView &value) { set(flag_expiration, value);      }
+    void setReplyTo         (const StringView &value) { set(flag_replyTo, value);         }
+    void setCorrelationID   (const StringView &value) { set(flag_correlationID, value);   }
+    void setPriority        (uint8_t value)           { decode(); _priority = value;      _flags |= flag_priority;     }
+    void setDeliveryMode    (uint8_t value)           { decode(); _deliveryMode = value;  _flags |= flag_deliveryMode; }
+    void setContentEncoding (const StringView &value) { set(flag_contentEncoding, value); }
+    void setContentType     (const StringView &value) { set(flag_contentType, value);     }
+    void setClusterID       (const StringView &value) { set(flag_clusterID, value);       }
+    void setAppID           (const StringView &value) { set(flag_appID, value);           }
+    void setUserID          (const StringView &value) { set(flag_userID, value);          }
+    void setTypeName        (const StringView &value) { set(flag_typeName, value);        }
+    void setTimestamp       (uint64_t value)          { decode(); _timestamp = value;     _flags |= flag_timestamp;    }
+    void setMessageID       (const StringView &value) { set(flag_messageID, value);       }
+
+    /**
+     *  Set the headers
+     *  @param  value
+     */
+    void setHeaders(const Table &value)
+    {
+        // make sure the properties are decoded
+        decode();
+
+        // copy the table (this keeps the type, an encoded table stays encoded)
+        Table *headers = static_cast<Table *>(value.copy(nullptr, 0));
+
+        // replace the current headers, the encoded table is no longer valid
+        if (_headers) delete _headers;
+        _headers = headers;
+        _table = 0;
+
+        // headers are now set
+        _flags |= flag_headers;
+    }
 
     /**
      *  Retrieve the fields
-     *  @return string
-     */
-    const std::string &expiration     () const { return _expiration;        }
-    const std::string &replyTo        () const { return _replyTo;           }
-    const std::string &correlationID  () const { return _correlationID;     }
-    const uint8_t      priority       () const { return _priority;          }
-    const uint8_t      deliveryMode   () const { return _deliveryMode;      }
-    const Table       &headers        () const { return _headers;           }
-    const std::string &contentEncoding() const { return _contentEncoding;   }
-    const std::string &contentType    () const { return _contentType;       }
-    const std::string &clusterID      () const { return _clusterID;         }
-    const std::string &appID          () const { return _appID;             }
-    const std::string &userID         () const { return _userID;            }
-    const std::string &typeName       () const { return _typeName;          }
-    const uint64_t     timestamp      () const { return _timestamp;         }
-    const std::string &messageID      () const { return _messageID;         }
-    
+     *
+     *  The string properties are copied into a std::string that is kept in
+     *  the object, which is valid until the object is destructed
+     *
+     *  @return std::string
+     */
+    const std::string &expiration     () const { return string(flag_expiration);      }
+    const std::string &replyTo        () const { return string(flag_replyTo);         }
+    const std::string &correlationID  () const { return string(flag_correlationID);   }
+    uint8_t            priority       () const { decode(); return _priority;          }
+    uint8_t            deliveryMode   () const { decode(); return _deliveryMode;      }
+    const std::string &contentEncoding() const { return string(flag_contentEncoding); }
+    const std::string &contentType    () const { return string(flag_contentType);     }
+    const std::string &clusterID      () const { return string(flag_clusterID);       }
+    const std::string &appID          () const { return string(flag_appID);           }
+    const std::string &userID         () const { return string(flag_userID);          }
+    const std::string &typeName       () const { return string(flag_typeName);        }
+    uint64_t           timestamp      () const { decode(); return _timestamp;         }
+    const std::string &messageID      () const { return string(flag_messageID);       }
+
+    /**
+     *  Retrieve the string fields without copying them
+     *
+     *  The returned string views point into the meta data object, and are
+     *  valid until the property is changed or the object is destructed
+     *
+     *  @return StringView
+     */
+    StringView expirationView     () const { return get(flag_expiration);      }
+    StringView replyToView        () const { return get(flag_replyTo);         }
+    StringView correlationIDView  () const { return get(flag_correlationID);   }
+    StringView contentEncodingView() const { return get(flag_contentEncoding); }
+    StringView contentTypeView    () const { return get(flag_contentType);     }
+    StringView clusterIDView      () const { return get(flag_clusterID);       }
+    StringView appIDView          () const { return get(flag_appID);           }
+    StringView userIDView         () const { return get(flag_userID);          }
+    StringView typeNameView       () const { return get(flag_typeName);        }
+    StringView messageIDView      () const { return get(flag_messageID);       }
+
+    /**
+     *  Retrieve the headers
+     *  @return Table
+     */
+    const Table &headers() const
+    {
+        // table that is returned if no headers are set
+        static Table empty;
+
+        // make sure the properties are decoded
+        decode();
+
+        // decode the table, if that did not yet happen
+        if (!_headers && _table > 0)
+        {
+            ByteBuffer buffer(strings() + _size, _table);
+            ReceivedFrame frame(buffer);
+            _headers = new Table(frame);
+        }
+
+        // return the headers
+        return _headers ? *_headers : empty;
+    }
+
+    /**
+     *  Retrieve a view on the encoded headers
+     *
+     *  Unlike headers(), this does not decode the table. The view points into
+     *  the meta data object, and is valid until the headers or one of the
+     *  string properties are changed, or the object is destructed
+     *
+     *  @return TableView
+     */
+    TableView headersView() const
+    {
+        // make sure the properties are decoded
+        decode();
+
+        // leap out if there are no headers
+        if (!hasHeaders()) return TableView();
+
+        // headers that were set by the user still have to be encoded
+        if (_table == 0)
+        {
+            // encode the table
+            OutBuffer buffer(_headers->size());
+            _headers->fill(buffer);
+
+            // and store it after the strings
+            reserve(_size + buffer.size());
+            memcpy(strings() + _size, buffer.data(), buffer.size());
+            _table = buffer.size();
+        }
+
+        // construct the view
+        return TableView(strings() + _size, _table);
+    }
+
     /**
      *  Is this a message with persistent storage
      *  This is an alias for retrieving the delivery mode and checking if it is set to 2
      *  @return bool
      */
-    bool persistent()
+    bool persistent() const
     {
         return hasDeliveryMode() && deliveryMode() == 2;
     }
-    
+
     /**
      *  Set whether storage should be persistent or not
      *  @param  bool
      */
     void setPersistent(bool value = true)
     {
-        if (value) 
+        if (value)
         {
             // simply set the delivery mode
             setDeliveryMode(2);
         }
-        else 
+        else
         {
             // we remove the field from the header
+            decode();
             _deliveryMode = 0;
-            _bools1.set(4,false);
+            _flags &= ~flag_deliveryMode;
         }
     }
 
@@ -271,53 +705,61 @@ public:
      */
     uint32_t size() const
     {
-        // the result (2 for the two boolean sets)
-        uint32_t result = 2;
-        
-        if (hasExpiration())        result += _expiration.size();
-        if (hasReplyTo())           result += _replyTo.size();
-        if (hasCorrelationID())     result += _correlationID.size();
-        if (hasPriority())          result += _priority.size();
-        if (hasDeliveryMode())      result += _deliveryMode.size();
-        if (hasHeaders())           result += _headers.size();
-        if (hasContentEncoding())   result += _contentEncoding.size();
-        if (hasContentType())       result += _contentType.size();
-        if (hasClusterID())         result += _clusterID.size();
-        if (hasAppID())             result += _appID.size();
-        if (hasUserID())            result += _userID.size();
-        if (hasTypeName())          result += _typeName.size();
-        if (hasTimestamp())         result += _timestamp.size();
-        if (hasMessageID())         result += _messageID.size();
-        
+        // the result (2 for the flags, plus the strings that are already in wire format)
+        uint32_t result = 2 + _size;
+
+        // raw properties are sent as they were received
+        if (_encoded) return result;
+
+        if (hasHeaders())           result += _table > 0 ? _table : _headers->size();
+        if (hasDeliveryMode())      result += 1;
+        if (hasPriority())          result += 1;
+        if (hasTimestamp())         result += 8;
+
         // done
         return result;
     }
-    
+
     /**
      *  Fill an output buffer
      *  @param  buffer
      */
     void fill(OutBuffer &buffer) const
     {
-        // the two boolean sets are always present
-        _bools1.fill(buffer);
-        _bools2.fill(buffer);
-        
-        // only copy the properties that were sent
-        if (hasContentType())       _contentType.fill(buffer);
-        if (hasContentEncoding())   _contentEncoding.fill(buffer);
-        if (hasHeaders())           _headers.fill(buffer);
-        if (hasDeliveryMode())      _deliveryMode.fill(buffer);
-        if (hasPriority())          _priority.fill(buffer);
-        if (hasCorrelationID())     _correlationID.fill(buffer);
-        if (hasReplyTo())           _replyTo.fill(buffer);
-        if (hasExpiration())        _expiration.fill(buffer);
-        if (hasMessageID())         _messageID.fill(buffer);
-        if (hasTimestamp())         _timestamp.fill(buffer);
-        if (hasTypeName())          _typeName.fill(buffer);
-        if (hasUserID())            _userID.fill(buffer);
-        if (hasAppID())             _appID.fill(buffer);
-        if (hasClusterID())         _clusterID.fill(buffer);
+        // the flags are always present
+        buffer.add(_flags);
+
+        // the string buffer
+        const char *data = strings();
+        size_t pos = 0;
+
+        // raw properties are sent as they were received
+        if (_encoded)
+        {
+            buffer.add(data, _size);
+            return;
+        }
+
+        // only copy the properties that were sent, in wire order
+        for (uint16_t bit = 0x8000; bit & flag_all; bit >>= 1)
+        {
+            // skip properties that are not set
+            if (!(_flags & bit)) continue;
+
+            // the scalar properties and the headers
+            if (bit == flag_headers && _table)  buffer.add(data + _size, _table);
+            else if (bit == flag_headers)       _headers->fill(buffer);
+            else if (bit == flag_deliveryMode)  buffer.add(_deliveryMode);
+            else if (bit == flag_priority)      buffer.add(_priority);
+            else if (bit == flag_timestamp)     buffer.add(_timestamp);
+            else
+            {
+                // strings are already in wire format, size byte included
+                uint32_t size = 1 + (uint8_t)data[pos];
+                buffer.add(data + pos, size);
+                pos += size;
+            }
+        }
     }
 };
 
@@ -325,4 +767,3 @@ public:
  *  End of namespace
  */
 }
-
@@ -0,0 +1,274 @@
+#pragma once
+/**
+ *  QosController.h
+ *
+ *  Class that tunes the prefetch count of a consuming channel while it runs.
+ *
+ *  A small prefetch count is safe, but it leaves the consumer idle while the
+ *  next message is on its way whenever the network round trip takes longer
+ *  than handling a message. A big prefetch count keeps the consumer busy, but
+ *  can use a lot of memory when messages are big. The controller measures
+ *  both the time it takes to handle a message and the round trip time to the
+ *  server, and keeps just enough messages underway to hide the round trip.
+ *
+ *  It can also enforce a limit on the number of bytes of unacknowledged
+ *  messages. When the limit is reached, the prefetch count is lowered to one.
+ *  The messages that are already underway still arrive, but after that the
+ *  server only delivers a next message when all earlier ones are acked, one
+ *  message at a time, until the controller raises the count again.
+ *
+ *  The controller owns the prefetch count of the channel, so do not call
+ *  Channel::setQos() yourself. The count is set for the whole channel (the
+ *  global flag), because RabbitMQ only applies a per-consumer count to the
+ *  consumers that are started after it: changes would not reach a consumer
+ *  that is already running. All consumers on the channel share the count.
+ *
+ *  The application reports every received message to the controller, and
+ *  acks or rejects messages via the controller instead of via the channel:
+ *
+ *      AMQP::QosController controller(&channel, 1, 500, 64 * 1024 * 1024);
+ *      channel.consume("queue").onReceived([&](const AMQP::Message &message, uint64_t deliveryTag, bool redelivered) {
+ *
+ *          controller.received(message, deliveryTag);
+ *
+ *          // handle the message
+ *
+ *          controller.ack(deliveryTag);
+ *      });
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class QosController : public Watchable
+{
+private:
+    /**
+     *  The clock that is used for the measurements
+     */
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     *  Information about a message that was not yet acknowledged
+     */
+    struct Delivery
+    {
+        /**
+         *  Size of the message body
+         *  @var uint64_t
+         */
+        uint64_t size;
+
+        /**
+         *  When the message was received
+         *  @var Clock::time_point
+         */
+        Clock::time_point received;
+    };
+
+    /**
+     *  The channel that is controlled
+     *  @var Channel
+     */
+    Channel *_channel;
+
+    /**
+     *  The lowest and highest prefetch count that may be used
+     *  @var uint16_t
+     */
+    uint16_t _minimum;
+    uint16_t _maximum;
+
+    /**
+     *  Maximum number of bytes in unacknowledged messages, zero for no limit
+     *  @var uint64_t
+     */
+    uint64_t _limit;
+
+    /**
+     *  The messages that were not yet acknowledged, by delivery tag
+     *  @var std::map
+     */
+    std::map<uint64_t, Delivery> _deliveries;
+
+    /**
+     *  Number of bytes in unacknowledged messages
+     *  @var uint64_t
+     */
+    uint64_t _bytes = 0;
+
+    /**
+     *  When the last message was acknowledged
+     *  @var Clock::time_point
+     */
+    Clock::time_point _lastAck;
+
+    /**
+     *  Smoothed time to handle a message, round trip time and message size
+     *  @var double
+     */
+    double _processing = 0.0;
+    double _latency = 0.0;
+    double _size = 0.0;
+
+    /**
+     *  The prefetch count that was last sent to the server
+     *  @var uint16_t
+     */
+    uint16_t _prefetch;
+
+    /**
+     *  Is a qos instruction on its way, and when was it sent?
+     *  @var bool
+     */
+    bool _pending = false;
+    Clock::time_point _sent;
+
+    /**
+     *  Is delivery paused because of the byte limit?
+     *  @var bool
+     */
+    bool _paused = false;
+
+    /**
+     *  Send a new prefetch count to the server
+     *  @param  prefetch
+     */
+    void send(uint16_t prefetch);
+
+    /**
+     *  Calculate the prefetch count to use, and send it when it is different
+     */
+    void adjust();
+
+    /**
+     *  Forget about acknowledged or rejected messages
+     *  @param  deliveryTag
+     *  @param  flags
+     */
+    void remove(uint64_t deliveryTag, int flags);
+
+public:
+    /**
+     *  Constructor
+     *
+     *  The controller immediately sets the minimum prefetch count, and
+     *  changes it as soon as it knows more about the message traffic.
+     *
+     *  @param  channel     the channel that consumes the messages
+     *  @param  minimum     lowest prefetch count to use
+     *  @param  maximum     highest prefetch count to use
+     *  @param  limit       maximum bytes in unacknowledged messages, zero for no limit
+     */
+    QosController(Channel *channel, uint16_t minimum = 1, uint16_t maximum = 1000, uint64_t limit = 0);
+
+    /**
+     *  The controller can not be copied
+     *  @param  that
+     */
+    QosController(const QosController &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~QosController() {}
+
+    /**
+     *  Report that a message was received
+     *  @param  deliveryTag     delivery tag of the message
+     *  @param  size            size of the message body
+     */
+    void received(uint64_t deliveryTag, uint64_t size);
+
+    /**
+     *  Report that a message was received
+     *  @param  message         the message
+     *  @param  deliveryTag     delivery tag of the message
+     */
+    void received(const Message &message, uint64_t deliveryTag)
+    {
+        received(deliveryTag, message.bodySize());
+    }
+
+    /**
+     *  Acknowledge a message, this accepts the same flags as Channel::ack()
+     *  @param  deliveryTag     the delivery tag of the message
+     *  @param  flags           optional flags
+     *  @return bool
+     */
+    bool ack(uint64_t deliveryTag, int flags = 0);
+
+    /**
+     *  Reject a message, this accepts the same flags as Channel::reject()
+     *  @param  deliveryTag     the delivery tag of the message
+     *  @param  flags           optional flags
+     *  @return bool
+     */
+    bool reject(uint64_t deliveryTag, int flags = 0);
+
+    /**
+     *  The prefetch count that was last sent to the server
+     *  @return uint16_t
+     */
+    uint16_t prefetch() const
+    {
+        return _prefetch;
+    }
+
+    /**
+     *  Number of unacknowledged messages
+     *  @return size_t
+     */
+    size_t messages() const
+    {
+        return _deliveries.size();
+    }
+
+    /**
+     *  Number of bytes in unacknowledged messages
+     *  @return uint64_t
+     */
+    uint64_t bytes() const
+    {
+        return _bytes;
+    }
+
+    /**
+     *  Is delivery paused, because too many bytes are not yet acknowledged?
+     *  @return bool
+     */
+    bool paused() const
+    {
+        return _paused;
+    }
+
+    /**
+     *  Average time to handle a message, in seconds
+     *  @return double
+     */
+    double processingTime() const
+    {
+        return _processing;
+    }
+
+    /**
+     *  Average round trip time to the server, in seconds
+     *  @return double
+     */
+    double latency() const
+    {
+        return _latency;
+    }
+};
+
+/**
+ *  End namespace
+ */
+}
@@ -123,6 +123,13 @@ public:
      */
     ReceivedFrame(const Buffer &buffer, uint32_t max);
 
+    /**
+     *  Constructor to read data that was earlier copied out of a frame,
+     *  the buffer holds no frame header, and the frame can not be processed
+     *  @param  buffer      Binary buffer
+     */
+    ReceivedFrame(const Buffer &buffer) : _buffer(buffer) {}
+
     /**
      *  Destructor
      */
@@ -239,6 +246,12 @@ public:
      */
     const char *nextData(uint32_t size);
 
+    /**
+     *  Get a view on the next short string, without copying it
+     *  @return StringView
+     */
+    StringView nextShortString();
+
     /**
      *  Process the received frame
      * 
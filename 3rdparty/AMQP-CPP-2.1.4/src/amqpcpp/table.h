@@ -17,10 +17,11 @@ class Table : public Field
 {
 private:
     /**
-     *  We define a custom type for storing fields
+     *  We define a custom type for storing fields: a vector of name-value
+     *  pairs, sorted by name, in which the values are stored inline
      *  @typedef    FieldMap
      */
-    typedef std::map<std::string, std::shared_ptr<Field> > FieldMap;
+    typedef std::vector<std::pair<std::string, FieldValue>> FieldMap;
 
     /**
      *  Store the fields
@@ -28,6 +29,24 @@ private:
      */
     FieldMap _fields;
 
+    /**
+     *  Find the position of a field, or the position where it should be inserted
+     *  @param  name    field name
+     *  @return size_t
+     */
+    size_t position(const StringView &name) const;
+
+    /**
+     *  Is the field at a certain position the field with a certain name?
+     *  @param  pos     position returned by position()
+     *  @param  name    field name
+     *  @return bool
+     */
+    bool matches(size_t pos, const StringView &name) const
+    {
+        return pos < _fields.size() && StringView(_fields[pos].first) == name;
+    }
+
 public:
     /**
      *  Constructor that creates an empty table
@@ -51,7 +70,7 @@ public:
      *  Move constructor
      *  @param  table
      */
-    Table(Table &&table) : _fields(std::move(table._fields)) {}
+    Table(Table &&table) noexcept : _fields(std::move(table._fields)) {}
 
     /**
      *  Destructor
@@ -81,6 +100,27 @@ public:
         return std::make_shared<Table>(*this);
     }
 
+    /**
+     *  Create a copy of this object in a buffer
+     *  @param  buffer
+     *  @param  size
+     *  @return Field*
+     */
+    virtual Field *copy(void *buffer, size_t size) const override
+    {
+        return Field::copy(*this, buffer, size);
+    }
+
+    /**
+     *  Move this object into a buffer
+     *  @param  buffer
+     *  @return Field*
+     */
+    virtual Field *move(void *buffer) noexcept override
+    {
+        return Field::move(*this, buffer);
+    }
+
     /**
      *  Get the size this field will take when
      *  encoded in the AMQP wire-frame format
@@ -92,15 +132,9 @@ public:
      *
      *  @param  name    field name
      *  @param  value   field value
+     *  @return Table
      */
-    Table set(const std::string& name, const Field &value)
-    {
-        // copy to a new pointer and store it
-        _fields[name] = value.clone();
-
-        // allow chaining
-        return *this;
-    }
+    Table &set(const StringView &name, const Field &value);
 
     /**
      *  Get a field
@@ -110,7 +144,7 @@ public:
      *  @param  name    field name
      *  @return         the field value
      */
-    const Field &get(const std::string &name) const;
+    const Field &get(const StringView &name) const;
 
     /**
      *  Get a field
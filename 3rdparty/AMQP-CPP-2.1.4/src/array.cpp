@@ -24,15 +24,12 @@ Array::Array(ReceivedFrame &frame)
         // one byte less for the field type
         charsToRead -= 1;
 
-        // read the field type and construct the field
-        Field *field = Field::decode(frame);
-        if (!field) continue;
+        // read the field type and construct the field in place
+        _fields.emplace_back(frame);
+        if (!_fields.back().valid()) { _fields.pop_back(); continue; }
 
         // less bytes to read
-        charsToRead -= field->size();
-
-        // add the additional field
-        _fields.push_back(std::shared_ptr<Field>(field));
+        charsToRead -= _fields.back()->size();
     }
 }
 
@@ -40,15 +37,7 @@ Array::Array(ReceivedFrame &frame)
  *  Copy constructor
  *  @param  array
  */
-Array::Array(const Array &array)
-{
-    // loop through the other array
-    for (auto iter = array._fields.begin(); iter != array._fields.end(); iter++)
-    {
-        // add to this vector
-        _fields.push_back(std::shared_ptr<Field>((*iter)->clone()));
-    }
-}
+Array::Array(const Array &array) : _fields(array._fields) {}
 
 /**
  *  Get a field
@@ -93,7 +82,7 @@ void Array::pop_back()
  */
 void Array::push_back(const Field& value)
 {
-    _fields.push_back(std::shared_ptr<Field>(value.clone()));
+    _fields.emplace_back(value);
 }
 
 /**
@@ -107,7 +96,7 @@ size_t Array::size() const
     size_t size = 4;
 
     // iterate over all elements
-    for (auto item : _fields)
+    for (auto &item : _fields)
     {
         // add the size of the field type and size of element
         size += sizeof(item->typeID());
@@ -128,7 +117,7 @@ void Array::fill(OutBuffer& buffer) const
     buffer.add(static_cast<uint32_t>(size()-4));
 
     // iterate over all elements
-    for (auto item : _fields)
+    for (auto &item : _fields)
     {
         // encode the element type and element
         buffer.add((uint8_t)item->typeID());
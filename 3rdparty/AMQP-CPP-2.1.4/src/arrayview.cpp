@@ -0,0 +1,110 @@
+/**
+ *  ArrayView.cpp
+ *
+ *  @copyright 2014 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Construct a view on an encoded array
+ *  @param  data    the encoded array, starting with the size
+ *  @param  size    number of bytes available
+ */
+ArrayView::ArrayView(const char *data, size_t size) : ArrayView()
+{
+    // the array starts with its size
+    if (size < 4) return;
+    uint32_t length = FieldView('i', data, 4).integer();
+
+    // the elements should fit in the buffer
+    if (length > size - 4) return;
+
+    // store the elements
+    _data = data;
+    _size = length;
+}
+
+/**
+ *  Parse the element at the current position
+ */
+void ArrayView::iterator::parse()
+{
+    // nothing left?
+    if (_pos == _end) return;
+
+    // the value follows the type
+    const char *data = _pos + 1;
+    uint32_t size = FieldView::measure(_pos[0], data, _end - data);
+
+    // stop at invalid values
+    if (size == 0) { _pos = _end; return; }
+
+    // store the element
+    _value = FieldView(_pos[0], data, size);
+}
+
+/**
+ *  Number of elements in the array
+ *  @return uint32_t
+ */
+uint32_t ArrayView::count() const
+{
+    // walk over all elements
+    uint32_t result = 0;
+    for (auto iter = begin(); iter != end(); ++iter) result++;
+
+    // done
+    return result;
+}
+
+/**
+ *  Can all elements be parsed, including those of nested tables and arrays?
+ *  @return bool
+ */
+bool ArrayView::valid() const
+{
+    // number of bytes used by the elements that could be parsed
+    uint32_t size = 0;
+
+    // walk over all elements
+    for (auto &value : *this)
+    {
+        // nested tables and arrays should be valid too
+        if (value.isTable() && !value.table().valid()) return false;
+        if (value.isArray() && !value.array().valid()) return false;
+
+        // the type and the value
+        size += 1 + value.size();
+    }
+
+    // iterating stops at the first invalid element, so it should not have left bytes behind
+    return size == _size;
+}
+
+/**
+ *  Get an element
+ *  @param  index
+ *  @return FieldView
+ */
+FieldView ArrayView::get(uint32_t index) const
+{
+    // walk to the element
+    for (auto &value : *this)
+    {
+        // is this the element we're looking for?
+        if (index-- == 0) return value;
+    }
+
+    // not found
+    return FieldView();
+}
+
+/**
+ *  End of namespace
+ */
+}
@@ -45,11 +45,19 @@ private:
      */
     BooleanSet _bools;
 
+    /**
+     *  Storage for the table of a received frame
+     *  @var Table
+     */
+    Table _received;
+
      /**
       *  additional arguments, implementation dependent
+      *  The table is not copied: outgoing frames refer to the table that was passed
+      *  to the constructor, received frames to their own decoded copy
       *  @var Table
       */
-    Table _filter;
+    const Table &_filter;
 
     
 
@@ -103,7 +111,8 @@ public:
         _queueName(frame),
         _consumerTag(frame),
         _bools(frame),
-        _filter(frame)
+        _received(frame),
+        _filter(_received)
     {}
 
     /**
@@ -16,10 +16,19 @@ class BasicDeliverFrame : public BasicFrame
 {
 private:
     /**
-     *  identifier for the consumer, valid within current channel
+     *  Storage for the strings, only used when the frame is constructed by
+     *  ourselves, received frames refer to the strings in the input buffer
      *  @var ShortString
      */
-    ShortString _consumerTag;
+    ShortString _consumerTagStorage;
+    ShortString _exchangeStorage;
+    ShortString _routingKeyStorage;
+
+    /**
+     *  identifier for the consumer, valid within current channel
+     *  @var StringView
+     */
+    StringView _consumerTag;
 
     /**
      *  server-assigned and channel specific delivery tag
@@ -35,15 +44,15 @@ private:
 
     /**
      *  the name of the exchange to publish to. An empty exchange name means the default exchange.
-     *  @var ShortString
+     *  @var StringView
      */
-    ShortString _exchange;
+    StringView _exchange;
 
     /**
      *  Message routing key
-     *  @var ShortString
+     *  @var StringView
      */
-    ShortString _routingKey;
+    StringView _routingKey;
 
 protected:
     /**
@@ -55,11 +64,14 @@ protected:
     {
         BasicFrame::fill(buffer);
 
-        _consumerTag.fill(buffer);
+        buffer.add((uint8_t)_consumerTag.size());
+        buffer.add(_consumerTag.data(), _consumerTag.size());
         buffer.add(_deliveryTag);
         _redelivered.fill(buffer);
-        _exchange.fill(buffer);
-        _routingKey.fill(buffer);
+        buffer.add((uint8_t)_exchange.size());
+        buffer.add(_exchange.data(), _exchange.size());
+        buffer.add((uint8_t)_routingKey.size());
+        buffer.add(_routingKey.data(), _routingKey.size());
     }
 
 public:
@@ -76,25 +88,30 @@ public:
     BasicDeliverFrame(uint16_t channel, const std::string& consumerTag, uint64_t deliveryTag, bool redelivered = false, const std::string& exchange = "", const std::string& routingKey = "") :
         BasicFrame(channel, (consumerTag.length() + exchange.length() + routingKey.length() + 12)),
             // length of strings + 1 byte per string for stringsize, 8 bytes for uint64_t and 1 for bools
-        _consumerTag(consumerTag),
+        _consumerTagStorage(consumerTag),
+        _exchangeStorage(exchange),
+        _routingKeyStorage(routingKey),
+        _consumerTag(_consumerTagStorage.value()),
         _deliveryTag(deliveryTag),
         _redelivered(redelivered),
-        _exchange(exchange),
-        _routingKey(routingKey)
+        _exchange(_exchangeStorage.value()),
+        _routingKey(_routingKeyStorage.value())
     {}
 
     /**
      *  Construct a basic deliver frame from a received frame
      *
+     *  The strings are not copied, they refer to the buffer of the received frame
+     *
      *  @param  frame   received frame 
      */
     BasicDeliverFrame(ReceivedFrame &frame) :
         BasicFrame(frame),
-        _consumerTag(frame),
+        _consumerTag(frame.nextShortString()),
         _deliveryTag(frame.nextUint64()),
         _redelivered(frame),
-        _exchange(frame),
-        _routingKey(frame)
+        _exchange(frame.nextShortString()),
+        _routingKey(frame.nextShortString())
     {}
 
     /**
@@ -104,18 +121,18 @@ public:
 
     /**
      *  Return the name of the exchange to publish to
-     *  @return  string
+     *  @return  StringView
      */
-    const std::string& exchange() const
+    const StringView &exchange() const
     {
         return _exchange;
     }
 
     /**
      *  Return the routing key
-     *  @return  string
+     *  @return  StringView
      */
-    const std::string& routingKey() const
+    const StringView &routingKey() const
     {
         return _routingKey;
     }
@@ -151,9 +168,9 @@ public:
 
     /**
      *  Return the identifier for the consumer (channel specific)
-     *  @return  string
+     *  @return  StringView
      */
-    const std::string& consumerTag() const
+    const StringView &consumerTag() const
     {
         return _consumerTag;
     }
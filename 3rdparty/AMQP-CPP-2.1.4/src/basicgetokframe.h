@@ -28,16 +28,24 @@ private:
     BooleanSet _redelivered;
 
     /**
-     *  the name of the exchange to publish to. An empty exchange name means the default exchange.
+     *  Storage for the strings, only used when the frame is constructed by
+     *  ourselves, received frames refer to the strings in the input buffer
      *  @var ShortString
      */
-    ShortString _exchange;
+    ShortString _exchangeStorage;
+    ShortString _routingKeyStorage;
+
+    /**
+     *  the name of the exchange to publish to. An empty exchange name means the default exchange.
+     *  @var StringView
+     */
+    StringView _exchange;
 
     /**
      *  Message routing key
-     *  @var ShortString
+     *  @var StringView
      */
-    ShortString _routingKey;
+    StringView _routingKey;
 
     /**
      *  number of messages in the queue
@@ -59,8 +67,10 @@ protected:
         // encode rest of the fields
         buffer.add(_deliveryTag);
         _redelivered.fill(buffer);
-        _exchange.fill(buffer);
-        _routingKey.fill(buffer);
+        buffer.add((uint8_t)_exchange.size());
+        buffer.add(_exchange.data(), _exchange.size());
+        buffer.add((uint8_t)_routingKey.size());
+        buffer.add(_routingKey.data(), _routingKey.size());
         buffer.add(_messageCount);
     }
 
@@ -79,8 +89,10 @@ public:
         BasicFrame(channel, (exchange.length() + routingKey.length() + 15)), // string length, +1 for each shortsrting length + 8 (uint64_t) + 4 (uint32_t) + 1 (bool)
         _deliveryTag(deliveryTag),
         _redelivered(redelivered),
-        _exchange(exchange),
-        _routingKey(routingKey),
+        _exchangeStorage(exchange),
+        _routingKeyStorage(routingKey),
+        _exchange(_exchangeStorage.value()),
+        _routingKey(_routingKeyStorage.value()),
         _messageCount(messageCount)
     {}
 
@@ -93,8 +105,8 @@ public:
         BasicFrame(frame),
         _deliveryTag(frame.nextUint64()),
         _redelivered(frame),
-        _exchange(frame),
-        _routingKey(frame),
+        _exchange(frame.nextShortString()),
+        _routingKey(frame.nextShortString()),
         _messageCount(frame.nextUint32())
     {}
 
@@ -105,18 +117,18 @@ public:
 
     /**
      *  Return the name of the exchange to publish to
-     *  @return string
+     *  @return StringView
      */
-    const std::string& exchange() const
+    const StringView &exchange() const
     {
         return _exchange;
     }
 
     /**
      *  Return the routing key
-     *  @return string
+     *  @return StringView
      */
-    const std::string& routingKey() const
+    const StringView &routingKey() const
     {
         return _routingKey;
     }
@@ -28,10 +28,23 @@ private:
     uint64_t _bodySize;
 
     /**
-     *  The meta data
+     *  The meta data that is sent (only for outgoing frames)
      *  @var MetaData
      */
-    MetaData _metadata;
+    const MetaData *_metadata = nullptr;
+
+    /**
+     *  The presence flags of the properties (only for incoming frames)
+     *  @var uint16_t
+     */
+    uint16_t _flags = 0;
+
+    /**
+     *  The raw properties, these are not decoded by the frame, but passed
+     *  on to the message as they are (only for incoming frames)
+     *  @var StringView
+     */
+    StringView _properties;
 
 protected:
     /**
@@ -49,14 +62,15 @@ protected:
         buffer.add(_bodySize);
 
         // the meta data
-        _metadata.fill(buffer);
+        _metadata->fill(buffer);
     }
 
 public:
     /**
      *  Construct an empty basic header frame
      *
-     *  All options are set using setter functions.
+     *  All options are set using setter functions. The envelope is not
+     *  copied, it should stay valid for as long as the frame exists.
      * 
      *  @param  channel     channel we're working on
      *  @param  envelope    the envelope
@@ -64,7 +78,23 @@ public:
     BasicHeaderFrame(uint16_t channel, const Envelope &envelope) :
         HeaderFrame(channel, 10 + envelope.size()), // there are at least 10 bytes sent, weight (2), bodySize (8), plus the size of the meta data
         _bodySize(envelope.bodySize()),
-        _metadata(envelope)
+        _metadata(&envelope)
+    {}
+
+    /**
+     *  Construct a header frame for a body that is sent separately
+     *
+     *  The body of the envelope is not used, only its meta data, which is
+     *  not copied and should stay valid for as long as the frame exists.
+     *
+     *  @param  channel     channel we're working on
+     *  @param  envelope    the envelope with the meta data
+     *  @param  bodySize    size of the body
+     */
+    BasicHeaderFrame(uint16_t channel, const Envelope &envelope, uint64_t bodySize) :
+        HeaderFrame(channel, 10 + envelope.size()),
+        _bodySize(bodySize),
+        _metadata(&envelope)
     {}
 
     /**
@@ -75,8 +105,12 @@ public:
         HeaderFrame(frame),
         _weight(frame.nextUint16()),
         _bodySize(frame.nextUint64()),
-        _metadata(frame)
-    {}
+        _flags(frame.nextUint16()),
+        _properties(frame.nextData(frame.payloadSize() - 14), frame.payloadSize() - 14)   // class id (2), weight (2), bodySize (8) and flags (2)
+    {
+        // the properties are decoded later, when the message is accessed, so they are checked now
+        if (!MetaData::valid(_flags, _properties)) throw ProtocolException("invalid message properties");
+    }
     
     /**
      *  Destructor
@@ -121,11 +155,14 @@ public:
         // store size
         message->setBodySize(_bodySize);
         
-        // and copy the meta data
-        message->set(_metadata);
+        // and copy the meta data, it is decoded when it is first accessed
+        message->setEncoded(_flags, _properties);
+
+        // streaming consumers get the headers right away, and the body later
+        if (channel->streaming()) channel->reportHeaders();
         
         // for empty bodies we're ready now
-        if (_bodySize == 0) channel->reportMessage();
+        else if (_bodySize == 0) channel->reportMessage();
         
         // done
         return true;
@@ -108,6 +108,14 @@ public:
         // is there a current message?
         MessageImpl *message = channel->message();
         if (!message) return false;
+
+        // streaming consumers get the data right away, it is not stored
+        if (channel->streaming())
+        {
+            // pass on the data
+            channel->reportChunk(_payload, _size);
+            return true;
+        }
         
         // store size
         if (!message->append(_payload, _size)) return true;
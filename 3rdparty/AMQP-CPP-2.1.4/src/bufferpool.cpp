@@ -0,0 +1,128 @@
+/**
+ *  BufferPool.cpp
+ *
+ *  Implementation file for the BufferPool class
+ *
+ *  @copyright 2014 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Namespace
+ */
+namespace AMQP {
+
+/**
+ *  Destructor
+ */
+BufferPool::~BufferPool()
+{
+    // free all buffers
+    for (auto &buffers : _free) for (auto buffer : buffers) delete[] buffer;
+}
+
+/**
+ *  The size class for a buffer size, or -1 if buffers of this size are not pooled
+ *  @param  size
+ *  @return int
+ */
+int BufferPool::index(uint64_t size)
+{
+    // too big to pool
+    if (size > (1ULL << largest)) return -1;
+
+    // find the smallest class that fits
+    int result = smallest;
+    while ((1ULL << result) < size) result++;
+
+    // done
+    return result - smallest;
+}
+
+/**
+ *  Get a buffer
+ *  @param  size        number of bytes that are needed
+ *  @param  capacity    set to the actual size of the buffer
+ *  @return char*
+ */
+char *BufferPool::allocate(uint64_t size, uint64_t &capacity)
+{
+    // the size class
+    int i = index(size);
+
+    // big buffers are allocated exactly
+    if (i < 0)
+    {
+        _misses++;
+        capacity = size;
+        return new char[size];
+    }
+
+    // the size of buffers in this class
+    capacity = 1ULL << (i + smallest);
+
+    // allocate if there is no free buffer
+    if (_free[i].empty())
+    {
+        _misses++;
+        return new char[capacity];
+    }
+
+    // take a buffer from the pool
+    char *buffer = _free[i].back();
+    _free[i].pop_back();
+    _pooled -= capacity;
+    _hits++;
+
+    // done
+    return buffer;
+}
+
+/**
+ *  Give a buffer back to the pool
+ *  @param  buffer      buffer that was returned by allocate()
+ *  @param  capacity    the capacity of the buffer
+ */
+void BufferPool::release(char *buffer, uint64_t capacity)
+{
+    // the size class
+    int i = index(capacity);
+
+    // big buffers, and buffers that do not fit in the pool, are freed
+    if (i < 0 || _pooled + capacity > _limit)
+    {
+        delete[] buffer;
+    }
+    else
+    {
+        // keep the buffer
+        _free[i].push_back(buffer);
+        _pooled += capacity;
+    }
+}
+
+/**
+ *  Drop free buffers until we are within the limit
+ */
+void BufferPool::trim()
+{
+    // start with the biggest buffers
+    for (int i = largest - smallest; i >= 0 && _pooled > _limit; i--)
+    {
+        // the size of buffers in this class
+        uint64_t capacity = 1ULL << (i + smallest);
+
+        // free buffers from this class
+        while (!_free[i].empty() && _pooled > _limit)
+        {
+            delete[] _free[i].back();
+            _free[i].pop_back();
+            _pooled -= capacity;
+        }
+    }
+}
+
+/**
+ *  End of namespace
+ */
+}
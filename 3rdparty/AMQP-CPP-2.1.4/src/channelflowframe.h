@@ -80,6 +80,33 @@ public:
     {
         return _active.get(0);
     }
+
+    /**
+     *  Process the frame
+     *
+     *  The server sends this frame to stop or restart the flow of published
+     *  messages on the channel
+     *
+     *  @param  connection      The connection over which it was received
+     *  @return bool            Was it succesfully processed?
+     */
+    virtual bool process(ConnectionImpl *connection) override
+    {
+        // we need the appropriate channel
+        auto channel = connection->channel(this->channel());
+
+        // channel does not exist
+        if (!channel) return false;
+
+        // confirm to the server that we got it
+        if (!connection->send(ChannelFlowOKFrame(this->channel(), active()))) return false;
+
+        // report the new state to the channel
+        channel->reportFlow(active());
+
+        // done
+        return true;
+    }
 };
 
 /**
@@ -13,6 +13,7 @@
 #include "consumedmessage.h"
 #include "returnedmessage.h"
 #include "channelopenframe.h"
+#include "channelflowokframe.h"
 #include "channelflowframe.h"
 #include "channelcloseokframe.h"
 #include "channelcloseframe.h"
@@ -31,6 +32,7 @@
 #include "basicpublishframe.h"
 #include "basicheaderframe.h"
 #include "bodyframe.h"
+#include "upload.h"
 #include "basicqosframe.h"
 #include "basicconsumeframe.h"
 #include "basiccancelframe.h"
@@ -55,6 +57,12 @@ ChannelImpl::~ChannelImpl()
     if (_message) delete _message;
     _message = nullptr;
 
+    // remove the messages that were not yet reported to batch consumers
+    for (auto message : _batch) if (message) delete message;
+
+    // remove the recycled messages
+    for (auto message : _recycled) delete message;
+
     // remove this channel from the connection (but not if the connection is already destructed)
     if (_connection) _connection->remove(this);
 }
@@ -105,6 +113,9 @@ Deferred &ChannelImpl::push(const std::shared_ptr<Deferred> &deferred)
     // store newest callback
     _newestCallback = deferred;
 
+    // one more operation waits for an answer
+    _sent++;
+
     // done
     return *deferred;
 }
@@ -115,8 +126,79 @@ Deferred &ChannelImpl::push(const std::shared_ptr<Deferred> &deferred)
  */
 Deferred &ChannelImpl::push(const Frame &frame)
 {
-    // send the frame, and push the result
-    return push(std::make_shared<Deferred>(!send(frame)));
+    // send the frame
+    auto deferred = allocate<Deferred>(!send(frame));
+
+    // frames sent with the nowait option are not answered
+    return frame.synchronous() ? push(deferred) : unanswered(deferred);
+}
+
+/**
+ *  Keep a deferred result for an operation that the server does not answer
+ *  @param  deferred        The deferred object
+ */
+Deferred &ChannelImpl::unanswered(const std::shared_ptr<Deferred> &deferred)
+{
+    // the operation is successful as soon as the frame is sent, so callbacks
+    // are called when they are installed
+    deferred->_nowait = true;
+
+    // keep the object alive until a later operation is answered, the caller
+    // holds a reference to it and may install an error callback
+    _nowaitCallbacks.emplace_back(_sent, deferred);
+
+    // done
+    return *deferred;
+}
+
+/**
+ *  Release the deferred results of nowait operations that were sent before
+ *  the synchronous operation that the server just answered
+ *
+ *  The server handles the operations in order, so these succeeded as well.
+ *
+ *  @return bool            Is the channel still valid?
+ */
+bool ChannelImpl::confirm()
+{
+    // one more operation was answered
+    _answered++;
+
+    // releasing a deferred result calls its finalize callback
+    Monitor monitor(this);
+
+    // release the results of the operations that were sent before it
+    while (!_nowaitCallbacks.empty() && _nowaitCallbacks.front().first < _answered)
+    {
+        // take it out of the list before it is destructed
+        auto deferred = std::move(_nowaitCallbacks.front().second);
+        _nowaitCallbacks.pop_front();
+
+        // destruct it
+        deferred = nullptr;
+
+        // leap out if channel no longer exists
+        if (!monitor.valid()) return false;
+    }
+
+    // we are still valid
+    return true;
+}
+
+/**
+ *  Release the deferred result of a consumer that was started with the
+ *  nowait flag, this is done when the consumer is cancelled
+ *  @param  consumertag     The consumer tag
+ */
+void ChannelImpl::release(const std::string &consumertag)
+{
+    // find the consumer
+    auto iter = _nowaitConsumers.find(consumertag);
+    if (iter == _nowaitConsumers.end()) return;
+
+    // take it out of the map, it is destructed when we return
+    auto deferred = std::move(iter->second);
+    _nowaitConsumers.erase(iter);
 }
 
 /**
@@ -192,7 +274,7 @@ Deferred &ChannelImpl::rollbackTransaction()
 Deferred &ChannelImpl::close()
 {
     // this is completely pointless if not connected
-    if (_state != state_connected) return push(std::make_shared<Deferred>(_state == state_closing));
+    if (_state != state_connected) return push(allocate<Deferred>(_state == state_closing));
     
     // send a channel close frame
     auto &handler = push(ChannelCloseFrame(_id));
@@ -225,7 +307,7 @@ Deferred &ChannelImpl::declareExchange(const std::string &name, ExchangeType typ
     if (type == ExchangeType::headers)exchangeType = "headers";
 
     // send declare exchange frame
-    return push(ExchangeDeclareFrame(_id, name, exchangeType, flags & passive, flags & durable, false, arguments));
+    return push(ExchangeDeclareFrame(_id, name, exchangeType, flags & passive, flags & durable, flags & nowait, arguments));
 }
 
 /**
@@ -234,15 +316,16 @@ Deferred &ChannelImpl::declareExchange(const std::string &name, ExchangeType typ
  *  @param  source      exchange which binds to target
  *  @param  target      exchange to bind to
  *  @param  routingKey  routing key
+ *  @param  flags       additional flags
  *  @param  arguments   additional arguments for binding
  *
  *  This function returns a deferred handler. Callbacks can be installed
  *  using onSuccess(), onError() and onFinalize() methods.
  */
-Deferred &ChannelImpl::bindExchange(const std::string &source, const std::string &target, const std::string &routingkey, const Table &arguments)
+Deferred &ChannelImpl::bindExchange(const std::string &source, const std::string &target, const std::string &routingkey, int flags, const Table &arguments)
 {
     // send exchange bind frame
-    return push(ExchangeBindFrame(_id, target, source, routingkey, false, arguments));
+    return push(ExchangeBindFrame(_id, target, source, routingkey, flags & nowait, arguments));
 }
 
 /**
@@ -251,15 +334,16 @@ Deferred &ChannelImpl::bindExchange(const std::string &source, const std::string
  *  @param  source      the source exchange
  *  @param  target      the target exchange
  *  @param  routingkey  the routing key
+ *  @param  flags       additional flags
  *  @param  arguments   additional unbind arguments
  *
  *  This function returns a deferred handler. Callbacks can be installed
  *  using onSuccess(), onError() and onFinalize() methods.
  */
-Deferred &ChannelImpl::unbindExchange(const std::string &source, const std::string &target, const std::string &routingkey, const Table &arguments)
+Deferred &ChannelImpl::unbindExchange(const std::string &source, const std::string &target, const std::string &routingkey, int flags, const Table &arguments)
 {
     // send exchange unbind frame
-    return push(ExchangeUnbindFrame(_id, target, source, routingkey, false, arguments));
+    return push(ExchangeUnbindFrame(_id, target, source, routingkey, flags & nowait, arguments));
 }
 
 /**
@@ -274,7 +358,7 @@ Deferred &ChannelImpl::unbindExchange(const std::string &source, const std::stri
 Deferred &ChannelImpl::removeExchange(const std::string &name, int flags)
 {
     // send delete exchange frame
-    return push(ExchangeDeleteFrame(_id, name, flags & ifunused, false));
+    return push(ExchangeDeleteFrame(_id, name, flags & ifunused, flags & nowait));
 }
 
 /**
@@ -288,14 +372,25 @@ Deferred &ChannelImpl::removeExchange(const std::string &name, int flags)
  */
 DeferredQueue &ChannelImpl::declareQueue(const std::string &name, int flags, const Table &arguments)
 {
+    // the nowait option can only be used if we know the name of the queue
+    bool noWait = (flags & nowait) && !name.empty();
+
     // the frame to send
-    QueueDeclareFrame frame(_id, name, flags & passive, flags & durable, flags & exclusive, flags & autodelete, false, arguments);
+    QueueDeclareFrame frame(_id, name, flags & passive, flags & durable, flags & exclusive, flags & autodelete, noWait, arguments);
 
     // send the queuedeclareframe
-    auto result = std::make_shared<DeferredQueue>(!send(frame));
+    auto result = allocate<DeferredQueue>(!send(frame));
 
-    // add the deferred result
-    push(result);
+    // without the nowait option we wait for the answer
+    if (!noWait) push(result);
+    else
+    {
+        // the server does not tell us the name, so we remember it ourselves
+        result->_name = name;
+
+        // keep the deferred result until callbacks are installed
+        unanswered(result);
+    }
 
     // done
     return *result;
@@ -307,15 +402,16 @@ DeferredQueue &ChannelImpl::declareQueue(const std::string &name, int flags, con
  *  @param  exchangeName    name of the exchange to bind to
  *  @param  queueName       name of the queue
  *  @param  routingkey      routingkey
+ *  @param  flags           additional flags
  *  @param  arguments       additional arguments
  *
  *  This function returns a deferred handler. Callbacks can be installed
  *  using onSuccess(), onError() and onFinalize() methods.
  */
-Deferred &ChannelImpl::bindQueue(const std::string &exchangeName, const std::string &queueName, const std::string &routingkey, const Table &arguments)
+Deferred &ChannelImpl::bindQueue(const std::string &exchangeName, const std::string &queueName, const std::string &routingkey, int flags, const Table &arguments)
 {
     // send the bind queue frame
-    return push(QueueBindFrame(_id, queueName, exchangeName, routingkey, false, arguments));
+    return push(QueueBindFrame(_id, queueName, exchangeName, routingkey, flags & nowait, arguments));
 }
 
 /**
@@ -358,7 +454,7 @@ DeferredDelete &ChannelImpl::purgeQueue(const std::string &name)
     QueuePurgeFrame frame(_id, name, false);
 
     // send the frame, and create deferred object
-    auto deferred = std::make_shared<DeferredDelete>(!send(frame));
+    auto deferred = allocate<DeferredDelete>(!send(frame));
 
     // push to list
     push(deferred);
@@ -391,7 +487,7 @@ DeferredDelete &ChannelImpl::removeQueue(const std::string &name, int flags)
     QueueDeleteFrame frame(_id, name, flags & ifunused, flags & ifempty, false);
 
     // send the frame, and create deferred object
-    auto deferred = std::make_shared<DeferredDelete>(!send(frame));
+    auto deferred = allocate<DeferredDelete>(!send(frame));
 
     // push to list
     push(deferred);
@@ -400,6 +496,16 @@ DeferredDelete &ChannelImpl::removeQueue(const std::string &name, int flags)
     return *deferred;
 }
 
+/**
+ *  Is publishing blocked, because the server stopped the flow on the channel,
+ *  or because it blocked the whole connection?
+ *  @return bool
+ */
+bool ChannelImpl::blocked() const
+{
+    return !_flowing || (_connection && _connection->blocked());
+}
+
 /**
  *  Publish a message to an exchange
  *
@@ -411,6 +517,10 @@ DeferredDelete &ChannelImpl::removeQueue(const std::string &name, int flags)
  */
 bool ChannelImpl::publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope)
 {
+    // the server does not accept messages right now, so the caller should
+    // drop or spool the message instead of filling up the output buffers
+    if (blocked()) return false;
+
     // we are going to send out multiple frames, each one will trigger a call to the handler,
     // which in turn could destruct the channel object, we need to monitor that
     Monitor monitor(this);
@@ -426,38 +536,223 @@ bool ChannelImpl::publish(const std::string &exchange, const std::string &routin
     // send header
     if (!send(BasicHeaderFrame(_id, envelope))) return false;
 
-    // channel and connection still valid?
-    if (!monitor.valid() || !_connection) return false;
+    // channel still valid?
+    if (!monitor.valid()) return false;
+
+    // send the body
+    return sendBody(envelope.body(), envelope.bodySize());
+}
+
+/**
+ *  Publish a message that was received, on this or on another connection
+ *
+ *  The raw properties of the received header are sent as they are, and the
+ *  body frames are sent from the segments of the body, so the properties
+ *  are not decoded and encoded again, and the body is not reassembled.
+ *
+ *  @param  exchange    the exchange to publish to
+ *  @param  routingkey  the routing key
+ *  @param  message     the received message
+ */
+bool ChannelImpl::republish(const std::string &exchange, const std::string &routingKey, const Message &message)
+{
+    // the server does not accept messages right now
+    if (blocked()) return false;
+
+    // the segments should hold the full body (messages for streaming consumers do not store the body)
+    auto &segments = message.segments();
+    uint64_t size = 0;
+    for (auto &segment : segments) size += segment.size;
+    if (size != message.bodySize()) return false;
+
+    // sending the frames could destruct the channel
+    Monitor monitor(this);
+
+    // send the publish frame, the new exchange and routing key are only in this frame
+    if (!send(BasicPublishFrame(_id, exchange, routingKey))) return false;
+
+    // channel still valid?
+    if (!monitor.valid()) return false;
+
+    // send the header, with the properties of the received message
+    if (!send(BasicHeaderFrame(_id, message))) return false;
+
+    // send the segments
+    for (auto &segment : segments)
+    {
+        // channel still valid?
+        if (!monitor.valid()) return false;
+
+        // send the body frames for this segment
+        if (!sendBody(segment.data, segment.size)) return false;
+    }
+
+    // done
+    return true;
+}
+
+/**
+ *  Send (a part of) a body, split up in frames
+ *  @param  data        the data to send
+ *  @param  size        size of the data
+ *  @return bool
+ */
+bool ChannelImpl::sendBody(const char *data, uint64_t size)
+{
+    // leap out if there is nothing to send
+    if (size == 0) return true;
+
+    // we need a connection for the frame size
+    if (!_connection) return false;
+
+    // sending the frames could destruct the channel
+    Monitor monitor(this);
 
     // the max payload size is the max frame size minus the bytes for headers and trailer
     uint32_t maxpayload = _connection->maxPayload();
-    uint32_t bytessent = 0;
-
-    // the buffer
-    const char *data = envelope.body();
-    uint32_t bytesleft = envelope.bodySize();
 
     // split up the body in multiple frames depending on the max frame size
-    while (bytesleft > 0)
+    while (size > 0)
     {
         // size of this chunk
-        uint32_t chunksize = std::min(maxpayload, bytesleft);
+        uint32_t chunksize = std::min<uint64_t>(maxpayload, size);
 
         // send out a body frame
-        if (!send(BodyFrame(_id, data + bytessent, chunksize))) return false;
+        if (!send(BodyFrame(_id, data, chunksize))) return false;
 
         // channel still valid?
         if (!monitor.valid()) return false;
 
         // update counters
-        bytessent += chunksize;
-        bytesleft -= chunksize;
+        data += chunksize;
+        size -= chunksize;
     }
 
     // done
     return true;
 }
 
+/**
+ *  Publish a message of which the body is read with a callback
+ *
+ *  Only the publish and header frame are sent right away, the body frames
+ *  are sent when the application calls Connection::pump()
+ *
+ *  @param  exchange    the exchange to publish to
+ *  @param  routingkey  the routing key
+ *  @param  envelope    the envelope with the meta data (its body is not used)
+ *  @param  size        size of the body
+ *  @param  reader      callback to read the body
+ */
+bool ChannelImpl::publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope, uint64_t size, const ReadCallback &reader)
+{
+    // the server does not accept messages right now
+    if (blocked()) return false;
+
+    // sending the frames could destruct the channel
+    Monitor monitor(this);
+
+    // send the publish frame
+    if (!send(BasicPublishFrame(_id, exchange, routingKey))) return false;
+
+    // channel still valid?
+    if (!monitor.valid()) return false;
+
+    // send the header, the body follows when the header was sent
+    return send(BasicHeaderFrame(_id, envelope, size), size > 0 ? std::make_shared<Upload>(size, reader) : nullptr);
+}
+
+/**
+ *  Publish a message of which the body is read from a file descriptor
+ *
+ *  @param  exchange    the exchange to publish to
+ *  @param  routingkey  the routing key
+ *  @param  envelope    the envelope with the meta data (its body is not used)
+ *  @param  size        size of the body
+ *  @param  fd          file descriptor to read the body from
+ */
+bool ChannelImpl::publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope, uint64_t size, int fd)
+{
+    // read the body from the file descriptor
+    return publish(exchange, routingKey, envelope, size, [fd](char *buffer, size_t size) -> size_t {
+
+        // read the data, and try again when interrupted
+        ssize_t result;
+        do result = ::read(fd, buffer, size);
+        while (result < 0 && errno == EINTR);
+
+        // errors are reported as an empty read
+        return result < 0 ? 0 : result;
+    });
+}
+
+/**
+ *  Send the next body frames of the streaming publish
+ *  @param  max         number of bytes to send (at least one frame is sent)
+ *  @return size_t      number of bytes sent
+ */
+size_t ChannelImpl::pump(size_t max)
+{
+    // skip if there is no body to send
+    if (!_upload || !_connection) return 0;
+
+    // sending and reading could destruct the channel
+    Monitor monitor(this);
+
+    // keep the upload while we are using it
+    auto upload = _upload;
+
+    // the max payload size is the max frame size minus the bytes for headers and trailer
+    uint32_t maxpayload = _connection->maxPayload();
+
+    // number of bytes sent
+    size_t sent = 0;
+
+    // send frames until we sent enough, or the body is complete
+    while (sent < max && upload->remaining() > 0)
+    {
+        // read the next part of the body
+        size_t size = upload->read(maxpayload);
+
+        // a message can not be aborted halfway, so a body that can not be read
+        // leaves the connection in a state in which it can not be used
+        if (size == 0)
+        {
+            // remember the connection, the channel is removed from it
+            auto *connection = _connection;
+
+            // report the error
+            reportError("Failed to read the body of a streaming publish");
+
+            // close the connection
+            if (monitor.valid()) connection->close();
+
+            // done
+            return sent;
+        }
+
+        // send out the body frame (the channel is blocked for other frames, so
+        // we pass it straight to the connection)
+        if (!_connection->send(BodyFrame(_id, upload->data(), size))) return sent;
+
+        // channel still valid?
+        if (!monitor.valid()) return sent;
+
+        // update counter
+        sent += size;
+    }
+
+    // leap out if the body is not yet complete
+    if (upload->remaining() > 0) return sent;
+
+    // the body was sent, the frames that were waiting can be sent now
+    _upload = nullptr;
+    onSynchronized();
+
+    // done
+    return sent;
+}
+
 /**
  *  Set the Quality of Service (QOS) for this channel
  *  @param  prefetchCount       maximum number of messages to prefetch
@@ -496,14 +791,28 @@ Deferred &ChannelImpl::setQos(uint16_t prefetchCount, bool global)
  */
 DeferredConsumer& ChannelImpl::consume(const std::string &queue, const std::string &tag, int flags, const Table &arguments)
 {
+    // the nowait option can only be used if we know the consumer tag
+    bool noWait = (flags & nowait) && !tag.empty();
+
     // the frame to send
-    BasicConsumeFrame frame(_id, queue, tag, flags & nolocal, flags & noack, flags & exclusive, false, arguments);
+    BasicConsumeFrame frame(_id, queue, tag, flags & nolocal, flags & noack, flags & exclusive, noWait, arguments);
 
     // send the frame, and create deferred object
-    auto deferred = std::make_shared<DeferredConsumer>(this, !send(frame));
+    auto deferred = allocate<DeferredConsumer>(this, !send(frame));
 
-    // push to list
-    push(deferred);
+    // without the nowait option we wait for the answer
+    if (!noWait) push(deferred);
+    else
+    {
+        // the server does not tell us the tag, so we remember it ourselves, the
+        // message callback is installed as soon as it is set
+        deferred->_tag = tag;
+        deferred->_nowait = true;
+
+        // keep the deferred result while the consumer runs, so that it can
+        // report it when the channel fails
+        _nowaitConsumers[tag] = deferred;
+    }
 
     // done
     return *deferred;
@@ -532,7 +841,7 @@ DeferredCancel &ChannelImpl::cancel(const std::string &tag)
     BasicCancelFrame frame(_id, tag, false);
 
     // send the frame, and create deferred object
-    auto deferred = std::make_shared<DeferredCancel>(this, !send(frame));
+    auto deferred = allocate<DeferredCancel>(this, !send(frame));
 
     // push to list
     push(deferred);
@@ -579,7 +888,7 @@ DeferredGet &ChannelImpl::get(const std::string &queue, int flags)
     BasicGetFrame frame(_id, queue, flags & noack);
     
     // send the frame, and create deferred object
-    auto deferred = std::make_shared<DeferredGet>(this, !send(frame));
+    auto deferred = allocate<DeferredGet>(this, !send(frame));
 
     // push to list
     push(deferred);
@@ -640,6 +949,18 @@ Deferred &ChannelImpl::recover(int flags)
  *  @return bool        was the frame sent?
  */
 bool ChannelImpl::send(const Frame &frame)
+{
+    // this is a frame without a streaming body
+    return send(frame, nullptr);
+}
+
+/**
+ *  Send a frame over the channel
+ *  @param  frame       frame to send
+ *  @param  upload      the body that should be sent after the frame
+ *  @return bool        was the frame sent?
+ */
+bool ChannelImpl::send(const Frame &frame, const std::shared_ptr<Upload> &upload)
 {
     // skip if channel is not connected
     if (_state == state_closed || !_connection) return false;
@@ -650,13 +971,13 @@ bool ChannelImpl::send(const Frame &frame)
     // the error when the close operation succeeds
     if (_state == state_closing) return true;
 
-    // are we currently in synchronous mode or are there
-    // other frames waiting for their turn to be sent?
-    if (_synchronous || !_queue.empty())
+    // are we currently in synchronous mode, busy with a streaming body, or
+    // are there other frames waiting for their turn to be sent?
+    if (_synchronous || _upload || !_queue.empty())
     {
         // we need to wait until the synchronous frame has
         // been processed, so queue the frame until it was
-        _queue.emplace(frame.synchronous(), frame.buffer());
+        _queue.emplace(frame.synchronous(), frame.buffer(), upload);
 
         // it was of course not actually sent but we pretend
         // that it was, because no error occured
@@ -666,8 +987,10 @@ bool ChannelImpl::send(const Frame &frame)
     // send to tcp connection
     if (!_connection->send(frame)) return false;
     
-    // frame was sent, if this was a synchronous frame, we now have to wait
+    // frame was sent, if this was a synchronous frame, we now have to wait,
+    // and if a streaming body follows, that should be sent first
     _synchronous = frame.synchronous();
+    _upload = upload;
     
     // done
     return true;
@@ -685,20 +1008,21 @@ void ChannelImpl::onSynchronized()
     // we need to monitor the channel for validity
     Monitor monitor(this);
 
-    // send all frames while not in synchronous mode
-    while (monitor.valid() && _connection && !_synchronous && !_queue.empty())
+    // send all frames while not in synchronous mode or sending a streaming body
+    while (monitor.valid() && _connection && !_synchronous && !_upload && !_queue.empty())
     {
         // retrieve the first buffer and synchronous
-        auto pair = std::move(_queue.front());
+        auto frame = std::move(_queue.front());
 
         // remove from the list
         _queue.pop();
 
-        // mark as synchronous if necessary
-        _synchronous = pair.first;
+        // mark as synchronous if necessary, and start the streaming body
+        _synchronous = frame.synchronous;
+        _upload = frame.upload;
 
         // send it over the connection
-        _connection->send(std::move(pair.second));
+        _connection->send(std::move(frame.buffer));
     }
 }
 
@@ -713,27 +1037,176 @@ void ChannelImpl::reportMessage()
     // after the report the channel may be destructed, monitor that
     Monitor monitor(this);
 
+    // the handle of the consumer
+    uint32_t consumer = _message->consumer();
+
     // synchronize the channel if this comes from a basic.get frame
-    if (_message->consumer().empty()) onSynchronized();
+    if (consumer == 0) onSynchronized();
 
     // syncing the channel may destruct the channel
     if (!monitor.valid()) return;
 
     // look for the consumer
-    auto iter = _consumers.find(_message->consumer());
-    if (iter == _consumers.end()) return;
+    if (consumer >= _consumers.size()) return;
+
+    // batch consumers get the message when the parse() call is complete
+    if (_consumers[consumer].batch)
+    {
+        // keep the message until then
+        _batch.push_back(_message);
+        _message = nullptr;
+        return;
+    }
 
     // is this a valid callback method
-    if (!iter->second) return;
+    if (!_consumers[consumer].message) return;
 
     // call the callback
-    _message->report(iter->second);
+    _message->report(_consumers[consumer].message);
+
+    // skip if channel was destructed
+    if (!monitor.valid()) return;
+
+    // no longer need the message, but keep the object for the next one
+    recycle();
+}
+
+/**
+ *  Is the message that is being received for a streaming consumer?
+ *  @return bool
+ */
+bool ChannelImpl::streaming() const
+{
+    // there should be a message
+    if (!_message) return false;
+
+    // the handle of the consumer
+    uint32_t consumer = _message->consumer();
+
+    // check the callbacks of the consumer
+    return consumer < _consumers.size() && _consumers[consumer].streaming();
+}
+
+/**
+ *  Report the headers of a message to a streaming consumer
+ */
+void ChannelImpl::reportHeaders()
+{
+    // after the report the channel may be destructed, monitor that
+    Monitor monitor(this);
+
+    // the callbacks of the consumer
+    auto &consumer = _consumers[_message->consumer()];
+
+    // report the message without its body
+    if (consumer.headers) consumer.headers(*_message, _message->deliveryTag(), _message->redelivered());
 
     // skip if channel was destructed
     if (!monitor.valid()) return;
 
-    // no longer need the message
-    delete _message; _message = nullptr;
+    // messages without a body are complete right away
+    if (_message && _message->bodySize() == 0) reportComplete();
+}
+
+/**
+ *  Report a part of the body to a streaming consumer
+ *  @param  data        the data
+ *  @param  size        size of the data
+ */
+void ChannelImpl::reportChunk(const char *data, uint64_t size)
+{
+    // after the report the channel may be destructed, monitor that
+    Monitor monitor(this);
+
+    // the data is passed on, and not stored in the message
+    bool complete = _message->skip(size);
+
+    // the callbacks of the consumer
+    auto &consumer = _consumers[_message->consumer()];
+
+    // report the data
+    if (consumer.chunk && size > 0) consumer.chunk(data, size);
+
+    // skip if channel was destructed
+    if (!monitor.valid()) return;
+
+    // report the end of the message
+    if (complete && _message) reportComplete();
+}
+
+/**
+ *  Report to a streaming consumer that the message is complete
+ */
+void ChannelImpl::reportComplete()
+{
+    // after the report the channel may be destructed, monitor that
+    Monitor monitor(this);
+
+    // the callbacks of the consumer
+    auto &consumer = _consumers[_message->consumer()];
+
+    // report the end of the message
+    if (consumer.complete) consumer.complete(_message->deliveryTag(), _message->redelivered());
+
+    // skip if channel was destructed
+    if (!monitor.valid()) return;
+
+    // no longer need the message, but keep the object for the next one
+    if (_message) recycle();
+}
+
+/**
+ *  Report the messages that were collected for batch consumers
+ */
+void ChannelImpl::reportBatch()
+{
+    // skip if there are no messages
+    if (_batch.empty()) return;
+
+    // the callbacks may destruct the channel, monitor that
+    Monitor monitor(this);
+
+    // the messages could be for different consumers, every consumer gets
+    // its own messages in one batch, in the order in which they arrived
+    for (size_t i = 0; i < _batch.size(); i++)
+    {
+        // skip messages that were already reported
+        if (!_batch[i]) continue;
+
+        // the consumer of this message
+        uint32_t consumer = _batch[i]->consumer();
+
+        // collect the messages of this consumer
+        _deliveries.clear();
+        for (size_t j = i; j < _batch.size(); j++)
+        {
+            // skip messages for other consumers
+            if (!_batch[j] || _batch[j]->consumer() != consumer) continue;
+
+            // add the message
+            _deliveries.emplace_back(_batch[j], _batch[j]->deliveryTag(), _batch[j]->redelivered());
+        }
+
+        // report the batch, the consumer could have been cancelled in the meantime
+        if (_consumers[consumer].batch) _consumers[consumer].batch(MessageBatch(_deliveries.data(), _deliveries.size()));
+
+        // skip if channel was destructed
+        if (!monitor.valid()) return;
+
+        // no longer need the messages, but keep the objects for the next ones
+        for (size_t j = i; j < _batch.size(); j++)
+        {
+            // skip messages for other consumers
+            if (!_batch[j] || _batch[j]->consumer() != consumer) continue;
+
+            // recycle the message
+            recycle(_batch[j]);
+            _batch[j] = nullptr;
+        }
+    }
+
+    // all messages have been reported
+    _batch.clear();
 }
 
 /**
@@ -746,6 +1219,7 @@ void ChannelImpl::reportError(const char *message, bool notifyhandler)
     // change state
     _state = state_closed;
     _synchronous = false;
+    _upload = nullptr;
     
     // the queue of messages that still have to sent can be emptied now
     // (we do this by moving the current queue into an unused variable)
@@ -791,6 +1265,33 @@ void ChannelImpl::reportError(const char *message, bool notifyhandler)
     // all callbacks have been processed, so we also can reset the pointer to the newest
     _newestCallback = nullptr;
 
+    // the results of nowait operations fail too, they are taken out of the
+    // channel first because the callbacks could start new operations
+    auto unanswered = std::move(_nowaitCallbacks);
+    auto consumers = std::move(_nowaitConsumers);
+    _nowaitCallbacks.clear();
+    _nowaitConsumers.clear();
+
+    // report the error to them
+    for (auto &iter : unanswered)
+    {
+        // call the callback
+        iter.second->reportError(message);
+
+        // leap out if channel no longer exists
+        if (!monitor.valid()) return;
+    }
+
+    // and to the consumers, so that they know they no longer receive messages
+    for (auto &iter : consumers)
+    {
+        // call the callback
+        iter.second->reportError(message);
+
+        // leap out if channel no longer exists
+        if (!monitor.valid()) return;
+    }
+
     // inform handler
     if (notifyhandler && _errorCallback) _errorCallback(message);
 
@@ -803,6 +1304,19 @@ void ChannelImpl::reportError(const char *message, bool notifyhandler)
 }
 
 
+/**
+ *  The pool for the buffers of message bodies
+ *  @return std::shared_ptr<BufferPool>
+ */
+std::shared_ptr<BufferPool> ChannelImpl::pool() const
+{
+    // without a connection the messages allocate their own buffers
+    if (!_connection) return nullptr;
+
+    // use the pool of the connection
+    return _connection->pool();
+}
+
 /**
  *  Create an incoming message from a consume call
  *  @param  frame
@@ -810,11 +1324,22 @@ void ChannelImpl::reportError(const char *message, bool notifyhandler)
  */
 ConsumedMessage *ChannelImpl::message(const BasicDeliverFrame &frame)
 {
-    // destruct if message is already set
-    if (_message) delete _message;
+    // recycle if message is already set
+    if (_message) recycle();
 
-    // construct a message
-    return _message = new ConsumedMessage(frame);
+    // the handle of the consumer
+    uint32_t handle = consumer(frame.consumerTag());
+
+    // construct a message if there is no object to reuse
+    if (_recycled.empty()) return _message = new ConsumedMessage(frame, handle, pool());
+
+    // reuse a recycled message
+    _message = _recycled.back();
+    _recycled.pop_back();
+    _message->reset(frame, handle);
+
+    // done
+    return _message;
 }
 
 /**
@@ -824,11 +1349,54 @@ ConsumedMessage *ChannelImpl::message(const BasicDeliverFrame &frame)
  */
 ConsumedMessage *ChannelImpl::message(const BasicGetOKFrame &frame)
 {
-    // destruct if message is already set
-    if (_message) delete _message;
+    // recycle if message is already set
+    if (_message) recycle();
     
-    // construct message
-    return _message = new ConsumedMessage(frame);
+    // construct message if there is no object to reuse
+    if (_recycled.empty()) return _message = new ConsumedMessage(frame, pool());
+
+    // reuse a recycled message
+    _message = _recycled.back();
+    _recycled.pop_back();
+    _message->reset(frame);
+
+    // done
+    return _message;
+}
+
+/**
+ *  Make sure that the message that is being received no longer refers
+ *  to the input buffer, because that buffer is about to be released
+ */
+void ChannelImpl::preserve()
+{
+    // copy the strings of the pending message
+    if (_message) _message->preserve();
+}
+
+/**
+ *  Recycle a message, so that its memory can be reused
+ *  @param  message
+ */
+void ChannelImpl::recycle(ConsumedMessage *message)
+{
+    // we keep enough objects for a batch of messages, the body buffers are
+    // not kept with them, they go back to the pool of the connection
+    static const size_t limit = 256;
+
+    // keep the object, unless we already have enough of them
+    if (_recycled.size() < limit) _recycled.push_back(message);
+    else delete message;
+}
+
+/**
+ *  Recycle the current message, so that its memory can be reused
+ */
+void ChannelImpl::recycle()
+{
+    // the current message becomes a recycled one
+    recycle(_message);
+    _message = nullptr;
 }
 
 /**
@@ -0,0 +1,104 @@
+/**
+ *  Class describing a connection blocked frame
+ *
+ *  The server sends this frame when it runs low on resources, and no
+ *  longer reads from connections that publish messages.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class implementation
+ */
+class ConnectionBlockedFrame : public ConnectionFrame
+{
+private:
+    /**
+     *  Why the connection is blocked
+     *  @var ShortString
+     */
+    ShortString _reason;
+
+protected:
+    /**
+     *  Encode a frame on a string buffer
+     *
+     *  @param  buffer  buffer to write frame to
+     */
+    virtual void fill(OutBuffer& buffer) const override
+    {
+        // call base
+        ConnectionFrame::fill(buffer);
+
+        // add fields
+        _reason.fill(buffer);
+    }
+
+public:
+    /**
+     *  Construct a connection blocked frame from a received frame
+     *
+     *  @param frame    received frame
+     */
+    ConnectionBlockedFrame(ReceivedFrame &frame) :
+        ConnectionFrame(frame),
+        _reason(frame)
+    {}
+
+    /**
+     *  Construct a connection blocked frame
+     *
+     *  @param  reason      why the connection is blocked
+     */
+    ConnectionBlockedFrame(const std::string &reason) :
+        ConnectionFrame(reason.length() + 1), // 1 for extra string byte
+        _reason(reason)
+    {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~ConnectionBlockedFrame() {}
+
+    /**
+     *  Method id
+     *  @return uint16_t
+     */
+    virtual uint16_t methodID() const override
+    {
+        return 60;
+    }
+
+    /**
+     *  Get the reason
+     *  @return string
+     */
+    const std::string& reason() const
+    {
+        return _reason;
+    }
+
+    /**
+     *  Process the frame
+     *  @param  connection
+     */
+    virtual bool process(ConnectionImpl *connection) override
+    {
+        // report that the connection is blocked
+        connection->reportBlocked(reason().c_str());
+
+        // done
+        return true;
+    }
+};
+
+/**
+ *  end namespace
+ */
+}
+
@@ -124,7 +124,15 @@ size_t ConnectionImpl::parse(const Buffer &buffer)
         {
             // try to recognize the frame
             ReceivedFrame receivedFrame(ReducedBuffer(buffer, processed), _maxFrame);
-            if (!receivedFrame.complete()) return processed;
+            if (!receivedFrame.complete())
+            {
+                // report the messages that were collected for batch consumers
+                if (!reportBatches()) return processed;
+
+                // the buffer will be released, pending messages can no longer refer to it
+                preserve();
+                return processed;
+            }
 
             // process the frame
             receivedFrame.process(this);
@@ -146,7 +154,16 @@ size_t ConnectionImpl::parse(const Buffer &buffer)
     }
 
     // leap out if the connection object no longer exists
-    if (!monitor.valid() || !_closed || _state != state_connected) return processed;
+    if (!monitor.valid()) return processed;
+
+    // report the messages that were collected for batch consumers
+    if (!reportBatches()) return processed;
+
+    // the buffer will be released, pending messages can no longer refer to it
+    preserve();
+
+    // leap out if the connection is not being closed
+    if (!_closed || _state != state_connected) return processed;
 
     // the close() function was called, but if the close frame was not yet sent
     // if there are no waiting channels, we can do that right now
@@ -274,6 +291,95 @@ bool ConnectionImpl::waiting() const
     return false;
 }
 
+/**
+ *  Make sure that messages that are not yet complete no longer refer
+ *  to the buffer that was passed to parse()
+ */
+void ConnectionImpl::preserve()
+{
+    // loop through the channels
+    for (auto &iter : _channels) iter.second->preserve();
+}
+
+/**
+ *  Report the messages that were collected for batch consumers on a channel
+ *  @param  id          the channel identifier
+ *  @return bool        does the connection still exist?
+ */
+bool ConnectionImpl::reportBatch(uint16_t id)
+{
+    // find the channel
+    auto iter = _channels.find(id);
+
+    // skip if there is nothing to report
+    if (iter == _channels.end() || !iter->second->batched()) return true;
+
+    // keep the channel alive, and check if the connection survives the callbacks
+    auto channel = iter->second;
+    Monitor monitor(this);
+
+    // report the messages
+    channel->reportBatch();
+
+    // done
+    return monitor.valid();
+}
+
+/**
+ *  Send the next part of the bodies of streaming publishes
+ *  @param  max         number of bytes to send (at least one frame is sent)
+ *  @return size_t      number of bytes sent
+ */
+size_t ConnectionImpl::pump(size_t max)
+{
+    // nothing is sent when the server does not read it
+    if (_state != state_connected || _blocked) return 0;
+
+    // sending could destruct the connection
+    Monitor monitor(this);
+
+    // number of bytes sent
+    size_t sent = 0;
+
+    // loop through the channels, by identifier because channels could be removed
+    uint16_t id = 0;
+    for (auto iter = _channels.begin(); iter != _channels.end() && sent < max; iter = _channels.upper_bound(id))
+    {
+        // keep the channel alive while it is sending
+        id = iter->first;
+        auto channel = iter->second;
+
+        // send the body frames of this channel
+        sent += channel->pump(max - sent);
+
+        // leap out if the connection no longer exists
+        if (!monitor.valid()) return sent;
+    }
+
+    // done
+    return sent;
+}
+
+/**
+ *  Report the messages that were collected for batch consumers
+ *  @return bool        does the connection still exist?
+ */
+bool ConnectionImpl::reportBatches()
+{
+    // loop through the channels, the callbacks could add or remove channels,
+    // so we look up the next channel by its identifier every time
+    uint16_t id = 0;
+    for (auto iter = _channels.begin(); iter != _channels.end(); iter = _channels.upper_bound(id))
+    {
+        // report the messages of this channel
+        id = iter->first;
+        if (!reportBatch(id)) return false;
+    }
+
+    // done
+    return true;
+}
+
 /**
  *  Send a frame over the connection
  *  @param  frame           The frame to send
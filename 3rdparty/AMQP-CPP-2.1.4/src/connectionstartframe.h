@@ -32,12 +32,34 @@ private:
     uint8_t _minor;
 
     /**
-     *  Additional server properties
+     *  The encoded server properties, only for frames that are not received
+     *  @var std::string
+     */
+    std::string _encoded;
+
+    /**
+     *  Additional server properties, these are not decoded, but refer to the
+     *  received frame (or to the encoded properties)
      *  @note:  exact properties are not specified
      *          and are implementation-dependent
-     *  @var Table
+     *  @var TableView
      */
-    Table _properties;
+    TableView _properties;
+
+    /**
+     *  Helper function to encode a table
+     *  @param  table
+     *  @return std::string
+     */
+    static std::string encode(const Table &table)
+    {
+        // encode the table into a buffer
+        OutBuffer buffer(table.size());
+        table.fill(buffer);
+
+        // turn it into a string
+        return std::string(buffer.data(), buffer.size());
+    }
 
     /**
      *  Available security mechanisms
@@ -65,7 +87,7 @@ protected:
         // encode all fields
         buffer.add(_major);
         buffer.add(_minor);
-        _properties.fill(buffer);
+        buffer.add(_properties.data(), _properties.size());
         _mechanisms.fill(buffer);
         _locales.fill(buffer);
     }
@@ -84,7 +106,8 @@ public:
         ConnectionFrame((properties.size() + mechanisms.length() + locales.length() + 10)), // 4 for each longstring (size-uint32), 2 major/minor
         _major(major),
         _minor(minor),
-        _properties(properties),
+        _encoded(encode(properties)),
+        _properties(_encoded.data(), _encoded.size()),
         _mechanisms(mechanisms),
         _locales(locales)
     {}
@@ -140,9 +163,9 @@ public:
      *  @note:  exact properties are not specified
      *          and are implementation-dependent
      * 
-     *  @return Table
+     *  @return TableView
      */
-    const Table& properties() const
+    const TableView &properties() const
     {
         return _properties;
     }
@@ -182,6 +205,11 @@ public:
         properties["platform"] = "Unknown";
         properties["copyright"] = "Copyright 2014 Copernica BV";
         properties["information"] = "http://www.copernica.com";
+
+        // tell the server which extensions we support
+        Table capabilities;
+        capabilities["connection.blocked"] = true;
+        properties.set("capabilities", capabilities);
         
         // move connection to handshake mode
         connection->setProtocolOk();
@@ -15,13 +15,21 @@ namespace AMQP {
 class ConnectionStartOKFrame : public ConnectionFrame
 {
 private:
+    /**
+     *  Storage for the table of a received frame
+     *  @var Table
+     */
+    Table _received;
+
     /**
      *  Additional client properties
      *  @note:  exact properties are not specified
      *          and are implementation-dependent
+     *  The table is not copied: outgoing frames refer to the table that was passed
+     *  to the constructor, received frames to their own decoded copy
      *  @var Table
      */
-    Table _properties;
+    const Table &_properties;
 
     /**
      *  The selected security mechanism
@@ -67,7 +75,8 @@ public:
      */
     ConnectionStartOKFrame(ReceivedFrame &frame) :
         ConnectionFrame(frame),
-        _properties(frame),
+        _received(frame),
+        _properties(_received),
         _mechanism(frame),
         _response(frame),
         _locale(frame)
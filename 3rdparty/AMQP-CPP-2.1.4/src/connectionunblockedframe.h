@@ -0,0 +1,81 @@
+/**
+ *  Class describing a connection unblocked frame
+ *
+ *  The server sends this frame when a blocked connection can be used
+ *  for publishing again.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class implementation
+ */
+class ConnectionUnblockedFrame : public ConnectionFrame
+{
+protected:
+    /**
+     *  Encode a frame on a string buffer
+     *
+     *  @param  buffer  buffer to write frame to
+     */
+    virtual void fill(OutBuffer& buffer) const override
+    {
+        // call base
+        ConnectionFrame::fill(buffer);
+    }
+
+public:
+    /**
+     *  Construct a connection unblocked frame from a received frame
+     *
+     *  @param frame    received frame
+     */
+    ConnectionUnblockedFrame(ReceivedFrame &frame) :
+        ConnectionFrame(frame)
+    {}
+
+    /**
+     *  Construct a connection unblocked frame
+     */
+    ConnectionUnblockedFrame() :
+        ConnectionFrame(0)
+    {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~ConnectionUnblockedFrame() {}
+
+    /**
+     *  Method id
+     *  @return uint16_t
+     */
+    virtual uint16_t methodID() const override
+    {
+        return 61;
+    }
+
+    /**
+     *  Process the frame
+     *  @param  connection
+     */
+    virtual bool process(ConnectionImpl *connection) override
+    {
+        // report that the connection can be used again
+        connection->reportUnblocked();
+
+        // done
+        return true;
+    }
+};
+
+/**
+ *  end namespace
+ */
+}
+
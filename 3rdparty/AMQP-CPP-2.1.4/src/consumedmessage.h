@@ -16,10 +16,10 @@ class ConsumedMessage : public MessageImpl
 {
 private:
     /**
-     *  The consumer tag
-     *  @var string
+     *  Handle of the consumer in the channel
+     *  @var uint32_t
      */
-    std::string _consumerTag;
+    uint32_t _consumer;
 
     /**
      *  The delivery tag
@@ -33,24 +33,56 @@ private:
      */
     bool _redelivered;
 
+    /**
+     *  Constructor for a message that takes over the contents of a delivered
+     *  message, it does not use the pool because it may go to other threads
+     *  @param  that        the delivered message
+     */
+    ConsumedMessage(ConsumedMessage &that) :
+        MessageImpl(that.exchangeView(), that.routingKeyView(), that.consumerTagView()),
+        _consumer(that._consumer), _deliveryTag(that._deliveryTag), _redelivered(that._redelivered)
+    {
+        // take over the body and the properties
+        take(that);
+    }
+
+    /**
+     *  Hand the message over to an OwnedMessage
+     *
+     *  The contents are moved to a new object, so that the object that
+     *  was passed to the callback stays with the channel.
+     *
+     *  @return Message
+     */
+    virtual const Message *detach() const override
+    {
+        // only complete messages that still have their body can be taken
+        if (!complete() || (!_body && _segments.empty() && _bodySize > 0)) return nullptr;
+
+        // the message is never really constant, it is owned by the channel
+        return new ConsumedMessage(*const_cast<ConsumedMessage*>(this));
+    }
 
 public:
     /**
      *  Constructor
      *  @param  frame
+     *  @param  consumer    handle of the consumer
+     *  @param  pool        pool for the body buffer
      */
-    ConsumedMessage(const BasicDeliverFrame &frame) :
-        MessageImpl(frame.exchange(), frame.routingKey()),
-        _consumerTag(frame.consumerTag()), _deliveryTag(frame.deliveryTag()), _redelivered(frame.redelivered())
+    ConsumedMessage(const BasicDeliverFrame &frame, uint32_t consumer, const std::shared_ptr<BufferPool> &pool) :
+        MessageImpl(pool, frame.exchange(), frame.routingKey(), frame.consumerTag()),
+        _consumer(consumer), _deliveryTag(frame.deliveryTag()), _redelivered(frame.redelivered())
     {}
 
     /**
      *  Constructor
      *  @param  frame
+     *  @param  pool        pool for the body buffer
      */
-    ConsumedMessage(const BasicGetOKFrame &frame) :
-        MessageImpl(frame.exchange(), frame.routingKey()),
-        _deliveryTag(frame.deliveryTag()), _redelivered(frame.redelivered())
+    ConsumedMessage(const BasicGetOKFrame &frame, const std::shared_ptr<BufferPool> &pool) :
+        MessageImpl(pool, frame.exchange(), frame.routingKey()),
+        _consumer(0), _deliveryTag(frame.deliveryTag()), _redelivered(frame.redelivered())
     {}
 
 
@@ -60,14 +92,63 @@ public:
     virtual ~ConsumedMessage() {}
 
     /**
-     *  Retrieve the consumer tag
-     *  @return std::string
+     *  Reuse the object for a new delivery
+     *  @param  frame
+     *  @param  consumer    handle of the consumer
+     */
+    void reset(const BasicDeliverFrame &frame, uint32_t consumer)
+    {
+        // reset the base
+        MessageImpl::reset(frame.exchange(), frame.routingKey(), frame.consumerTag());
+
+        // store the delivery information
+        _consumer = consumer;
+        _deliveryTag = frame.deliveryTag();
+        _redelivered = frame.redelivered();
+    }
+
+    /**
+     *  Reuse the object for a new message from a get operation
+     *  @param  frame
+     */
+    void reset(const BasicGetOKFrame &frame)
+    {
+        // reset the base
+        MessageImpl::reset(frame.exchange(), frame.routingKey());
+
+        // store the delivery information
+        _consumer = 0;
+        _deliveryTag = frame.deliveryTag();
+        _redelivered = frame.redelivered();
+    }
+
+    /**
+     *  Retrieve the consumer handle (zero for messages from a basic.get)
+     *  @return uint32_t
+     */
+    uint32_t consumer() const
+    {
+        return _consumer;
+    }
+
+    /**
+     *  Retrieve the delivery tag
+     *  @return uint64_t
      */
-    const std::string &consumer() const
+    uint64_t deliveryTag() const
     {
-        return _consumerTag;
+        return _deliveryTag;
     }
-     
+
+    /**
+     *  Is this a redelivered message?
+     *  @return bool
+     */
+    bool redelivered() const
+    {
+        return _redelivered;
+    }
+
     /**
      *  Report to the handler
      *  @param  callback
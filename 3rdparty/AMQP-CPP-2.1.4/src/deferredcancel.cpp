@@ -21,6 +21,9 @@ const std::shared_ptr<Deferred> &DeferredCancel::reportSuccess(const std::string
 {
     // in the channel, we should uninstall the consumer
     _channel->uninstall(name);
+
+    // a consumer that was started with the nowait option has nothing to report anymore
+    _channel->release(name);
     
     // skip if no special callback was installed
     if (!_cancelCallback) return Deferred::reportSuccess();
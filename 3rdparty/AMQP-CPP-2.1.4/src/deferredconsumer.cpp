@@ -20,7 +20,7 @@ namespace AMQP {
 const std::shared_ptr<Deferred> &DeferredConsumer::reportSuccess(const std::string &name) const
 {
     // we now know the name, so we can install the message callback on the channel
-    _channel->install(name, _messageCallback);
+    install(name);
     
     // skip if no special callback was installed
     if (!_consumeCallback) return Deferred::reportSuccess();
@@ -32,6 +32,24 @@ const std::shared_ptr<Deferred> &DeferredConsumer::reportSuccess(const std::stri
     return _next;
 }
 
+/**
+ *  Install the callbacks on the channel
+ *  @param  tag             Consumer tag
+ */
+void DeferredConsumer::install(const std::string &tag) const
+{
+    // the callbacks of the consumer
+    ChannelImpl::Consumer consumer;
+    consumer.message = _messageCallback;
+    consumer.batch = _batchCallback;
+    consumer.headers = _headersCallback;
+    consumer.chunk = _chunkCallback;
+    consumer.complete = _completeCallback;
+
+    // the channel can now pass messages to the callbacks
+    _channel->install(tag, consumer);
+}
+
 /**
  *  End namespace
  */
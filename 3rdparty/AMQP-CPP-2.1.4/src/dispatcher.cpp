@@ -0,0 +1,244 @@
+/**
+ *  Dispatcher.cpp
+ *
+ *  Implementation file for the Dispatcher class
+ *
+ *  @copyright 2014 Copernica BV
+ */
+#include "includes.h"
+#include "ring.h"
+#include "dispatcherlane.h"
+
+/**
+ *  Namespace
+ */
+namespace AMQP {
+
+/**
+ *  Hash a key (FNV-1a)
+ *  @param  key
+ *  @return uint64_t
+ */
+static uint64_t hash(const StringView &key)
+{
+    // start with the offset basis
+    uint64_t result = 14695981039346656037ULL;
+
+    // mix in all bytes
+    for (size_t i = 0; i < key.size(); i++)
+    {
+        result ^= (unsigned char)key.data()[i];
+        result *= 1099511628211ULL;
+    }
+
+    // done
+    return result;
+}
+
+/**
+ *  Constructor
+ *  @param  channel     the channel that consumes the messages
+ *  @param  lanes       number of worker threads
+ *  @param  key         callback that gives the key of a message
+ *  @param  handler     callback that handles a message
+ *  @param  capacity    number of messages that can be passed to a lane at once
+ */
+Dispatcher::Dispatcher(Channel *channel, size_t lanes, const KeyCallback &key, const MessageCallback &handler, size_t capacity) :
+    _channel(channel), _key(key), _handler(handler)
+{
+    // start the worker threads
+    for (size_t i = 0; i < std::max<size_t>(lanes, 1); i++) _lanes.emplace_back(new DispatcherLane(_handler, capacity));
+}
+
+/**
+ *  Destructor
+ */
+Dispatcher::~Dispatcher()
+{
+    // tell all threads to stop
+    for (auto &lane : _lanes) lane->stop();
+
+    // a thread can be waiting for room to pass back a tag, so we keep
+    // taking the tags until all threads have stopped
+    for (auto &lane : _lanes)
+    {
+        // wait for the thread
+        while (!lane->stopped()) if (collect(lane.get()) == 0) std::this_thread::yield();
+    }
+
+    // ack the messages that were handled
+    flush();
+
+    // destruct the lanes, this joins the threads
+    _lanes.clear();
+}
+
+/**
+ *  Pass a message to a worker
+ *  @param  message     the message passed to the callback
+ *  @param  deliveryTag the delivery tag passed to the callback
+ *  @param  redelivered the redelivered flag passed to the callback
+ *  @return bool        false if the message could not be taken over
+ */
+bool Dispatcher::dispatch(const Message &message, uint64_t deliveryTag, bool redelivered)
+{
+    // the key is taken before the message is moved away, without a key the lanes take turns
+    uint64_t lane = _key ? hash(_key(message)) % _lanes.size() : _next++ % _lanes.size();
+
+    // take over the message
+    OwnedMessage owned(message, deliveryTag, redelivered);
+    if (!owned) return false;
+
+    // it has to be acked
+    _outstanding.push_back(deliveryTag);
+
+    // pass it on to the lane
+    _lanes[lane]->add(std::move(owned));
+
+    // this is a good moment to send acks too
+    flush();
+
+    // done
+    return true;
+}
+
+/**
+ *  Take the handled and published messages from a lane
+ *  @param  lane
+ *  @return size_t      number of handled messages
+ */
+size_t Dispatcher::collect(DispatcherLane *lane)
+{
+    // number of handled messages
+    size_t result = 0;
+
+    // what the lane passed back
+    DispatcherLane::Reply reply;
+
+    // process everything in the order in which it was passed back
+    while (lane->replied(reply))
+    {
+        // publish messages that the handler published
+        if (reply.publish) _channel->publish(reply.publish->exchange, reply.publish->routingKey, reply.publish->envelope);
+
+        // or remember the handled message
+        else
+        {
+            // it is done
+            _finished.insert(reply.deliveryTag);
+            result++;
+
+            // a message for which the handler failed is rejected right away,
+            // and is then treated like a message that was acked on its own
+            if (reply.failed && _acked.insert(reply.deliveryTag).second) reject(reply.deliveryTag);
+        }
+
+        // the publish is no longer needed
+        reply.publish.reset();
+    }
+
+    // done
+    return result;
+}
+
+/**
+ *  Send the acks for the messages that were handled
+ *  @return size_t      number of messages that were handled since the last call
+ */
+size_t Dispatcher::flush()
+{
+    // number of handled messages
+    size_t result = 0;
+
+    // collect the handled messages, and pass on the messages that waited for room
+    for (auto &lane : _lanes)
+    {
+        result += collect(lane.get());
+        lane->feed();
+    }
+
+    // nothing to do if no messages were handled
+    if (_finished.empty()) return result;
+
+    // messages that were handled in the order of arrival are acked together
+    uint64_t multiple = 0;
+    while (!_outstanding.empty() && _finished.erase(_outstanding.front()) > 0)
+    {
+        // messages that were already acked on their own are not included
+        if (_acked.erase(_outstanding.front()) == 0) multiple = _outstanding.front();
+        _outstanding.pop_front();
+    }
+
+    // send the ack for all of them
+    if (multiple > 0) ack(multiple, AMQP::multiple);
+
+    // the other messages wait for an earlier message, ack them on their own,
+    // so that a slow message does not keep the acks of other keys back
+    for (auto tag : _finished)
+    {
+        // skip messages that were already acked
+        if (!_acked.insert(tag).second) continue;
+
+        // ack the message
+        ack(tag);
+    }
+
+    // done
+    return result;
+}
+
+/**
+ *  Send an ack, via the callback or the channel
+ *  @param  deliveryTag
+ *  @param  flags
+ *  @return bool
+ */
+bool Dispatcher::ack(uint64_t deliveryTag, int flags)
+{
+    return _ack ? _ack(deliveryTag, flags) : _channel->ack(deliveryTag, flags);
+}
+
+/**
+ *  Send a reject, via the callback or the channel
+ *  @param  deliveryTag
+ *  @param  flags
+ *  @return bool
+ */
+bool Dispatcher::reject(uint64_t deliveryTag, int flags)
+{
+    return _reject ? _reject(deliveryTag, flags) : _channel->reject(deliveryTag, flags);
+}
+
+/**
+ *  Publish a message from the handler
+ *  @param  exchange    the exchange to publish to
+ *  @param  routingKey  the routing key
+ *  @param  envelope    the full envelope to send
+ *  @return bool
+ */
+bool Dispatcher::publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope)
+{
+    // the lane of the current thread
+    auto *current = DispatcherLane::current();
+
+    // is this one of our worker threads?
+    for (auto &lane : _lanes)
+    {
+        // skip other lanes
+        if (lane.get() != current) continue;
+
+        // pass the message on to the thread of the connection
+        current->publish(exchange, routingKey, envelope);
+
+        // we do not know yet whether it can be published
+        return true;
+    }
+
+    // we are in the thread of the connection
+    return _channel->publish(exchange, routingKey, envelope);
+}
+
+/**
+ *  End of namespace
+ */
+}
@@ -0,0 +1,337 @@
+/**
+ *  DispatcherLane.h
+ *
+ *  A worker thread of a dispatcher. The messages are passed to the thread via
+ *  a ring, and the delivery tags of the messages that were handled, and the
+ *  messages that the handler published, are passed back via another ring.
+ *  The thread sleeps when it has nothing to do.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class DispatcherLane
+{
+public:
+    /**
+     *  A message that was published by the handler
+     */
+    struct Publish
+    {
+        /**
+         *  Where to publish to
+         *  @var std::string
+         */
+        std::string exchange;
+        std::string routingKey;
+
+        /**
+         *  The message, with a copy of the body
+         *  @var Envelope
+         */
+        Envelope envelope;
+
+        /**
+         *  Constructor
+         *  @param  exchange
+         *  @param  routingKey
+         *  @param  envelope
+         */
+        Publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope) :
+            exchange(exchange), routingKey(routingKey), envelope(std::string(envelope.body(), envelope.bodySize()))
+        {
+            // copy the properties too
+            this->envelope.set(envelope);
+        }
+    };
+
+    /**
+     *  What is passed back to the thread of the connection: the delivery tag
+     *  of a handled message, or a message to publish
+     */
+    struct Reply
+    {
+        /**
+         *  Delivery tag of the handled message
+         *  @var uint64_t
+         */
+        uint64_t deliveryTag = 0;
+
+        /**
+         *  Did the handler throw an exception?
+         *  @var bool
+         */
+        bool failed = false;
+
+        /**
+         *  The message to publish (instead of a delivery tag)
+         *  @var std::unique_ptr<Publish>
+         */
+        std::unique_ptr<Publish> publish;
+    };
+
+private:
+    /**
+     *  The handler of the messages
+     *  @var MessageCallback
+     */
+    const MessageCallback &_handler;
+
+    /**
+     *  Messages that are passed to the thread
+     *  @var Ring<OwnedMessage>
+     */
+    Ring<OwnedMessage> _messages;
+
+    /**
+     *  Handled messages and published messages, that are passed back
+     *  @var Ring<Reply>
+     */
+    Ring<Reply> _replies;
+
+    /**
+     *  Messages that did not fit in the ring, these are only used by the
+     *  thread of the connection
+     *  @var std::deque<OwnedMessage>
+     */
+    std::deque<OwnedMessage> _backlog;
+
+    /**
+     *  Mutex and condition to let the thread sleep
+     */
+    std::mutex _mutex;
+    std::condition_variable _condition;
+
+    /**
+     *  Is the thread sleeping, should it stop, and has it stopped?
+     *  @var std::atomic<bool>
+     */
+    std::atomic<bool> _sleeping;
+    std::atomic<bool> _stop;
+    std::atomic<bool> _stopped;
+
+    /**
+     *  The thread
+     *  @var std::thread
+     */
+    std::thread _thread;
+
+    /**
+     *  Wake up the thread if it is sleeping
+     */
+    void wake()
+    {
+        // the value that was pushed must be visible before we check whether
+        // the thread sleeps, the thread does the opposite
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // leap out if the thread is awake, it will see the message
+        if (!_sleeping.load()) return;
+
+        // wake it up, the lock makes sure it is waiting, or did not yet check the ring
+        std::lock_guard<std::mutex> lock(_mutex);
+        _condition.notify_one();
+    }
+
+    /**
+     *  Pass a message to the thread
+     *  @param  message
+     *  @return bool        false if the ring is full
+     */
+    bool push(OwnedMessage &&message)
+    {
+        // add to the ring
+        if (!_messages.push(std::move(message))) return false;
+
+        // make sure the thread sees it
+        wake();
+
+        // done
+        return true;
+    }
+
+    /**
+     *  Pass something back to the thread of the connection, when the ring
+     *  is full we wait for the connection to empty it
+     *  @param  reply
+     */
+    void send(Reply &&reply)
+    {
+        while (!_replies.push(std::move(reply))) std::this_thread::yield();
+    }
+
+    /**
+     *  Main loop of the thread
+     */
+    void run()
+    {
+        // the handler can find out in which lane it runs
+        current() = this;
+
+        // the message that is being handled
+        OwnedMessage message;
+
+        // keep running until we are told to stop
+        while (!_stop.load())
+        {
+            // is there a message?
+            if (_messages.pop(message))
+            {
+                // the tag that is passed back
+                Reply reply;
+                reply.deliveryTag = message.deliveryTag();
+
+                // handle it, an exception can not be passed on to the thread
+                // of the connection, so it only learns that the message failed
+                try
+                {
+                    _handler(*message, message.deliveryTag(), message.redelivered());
+                }
+                catch (...)
+                {
+                    reply.failed = true;
+                }
+
+                // destruct the message in this thread
+                message = OwnedMessage();
+
+                // pass the tag back, after the messages that the handler published
+                send(std::move(reply));
+
+                // next message
+                continue;
+            }
+
+            // wait for a message
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            // tell the producer that we are going to sleep before we check the ring again
+            _sleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // sleep until there is a message
+            _condition.wait(lock, [this]() { return _stop.load() || !_messages.empty(); });
+
+            // we are awake
+            _sleeping.store(false);
+        }
+
+        // we are done
+        _stopped.store(true);
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  handler     the handler of the messages
+     *  @param  capacity    size of the rings
+     */
+    DispatcherLane(const MessageCallback &handler, size_t capacity) :
+        _handler(handler), _messages(capacity), _replies(capacity),
+        _sleeping(false), _stop(false), _stopped(false),
+        _thread(&DispatcherLane::run, this) {}
+
+    /**
+     *  The lane can not be copied
+     *  @param  that
+     */
+    DispatcherLane(const DispatcherLane &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~DispatcherLane()
+    {
+        // stop the thread (if that did not yet happen)
+        stop();
+        if (_thread.joinable()) _thread.join();
+    }
+
+    /**
+     *  Pass a message to the thread
+     *  @param  message
+     */
+    void add(OwnedMessage &&message)
+    {
+        // messages that do not fit in the ring wait in the backlog, they
+        // also do when there are older messages in the backlog
+        if (!_backlog.empty() || !push(std::move(message))) _backlog.push_back(std::move(message));
+    }
+
+    /**
+     *  Move messages from the backlog to the ring
+     */
+    void feed()
+    {
+        // move as many as fit
+        while (!_backlog.empty() && push(std::move(_backlog.front()))) _backlog.pop_front();
+    }
+
+    /**
+     *  Publish a message, this is called by the handler, in the thread of the lane
+     *  @param  exchange
+     *  @param  routingKey
+     *  @param  envelope
+     */
+    void publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope)
+    {
+        // the message is copied, because the handler may reuse the envelope
+        Reply reply;
+        reply.publish.reset(new Publish(exchange, routingKey, envelope));
+
+        // pass it to the thread of the connection
+        send(std::move(reply));
+    }
+
+    /**
+     *  Get the next handled or published message
+     *  @param  reply
+     *  @return bool        false if there is nothing
+     */
+    bool replied(Reply &reply)
+    {
+        return _replies.pop(reply);
+    }
+
+    /**
+     *  The lane in which the current thread runs
+     *  @return DispatcherLane  nullptr if this is not the thread of a lane
+     */
+    static DispatcherLane *&current()
+    {
+        static thread_local DispatcherLane *lane = nullptr;
+        return lane;
+    }
+
+    /**
+     *  Tell the thread to stop after the message that it is handling
+     */
+    void stop()
+    {
+        // set the flag under the lock, so that the thread can not miss it
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop.store(true);
+        _condition.notify_one();
+    }
+
+    /**
+     *  Has the thread stopped?
+     *  @return bool
+     */
+    bool stopped() const
+    {
+        return _stopped.load();
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
@@ -42,11 +42,19 @@ private:
      */
     BooleanSet _bools;
 
+    /**
+     *  Storage for the table of a received frame
+     *  @var Table
+     */
+    Table _received;
+
     /**
      *  Additional arguments. Implementation dependent.
+     *  The table is not copied: outgoing frames refer to the table that was passed
+     *  to the constructor, received frames to their own decoded copy
      *  @var    Table
      */
-    Table _arguments;
+    const Table &_arguments;
 
 
 protected:
@@ -98,7 +106,8 @@ public:
         _name(frame),
         _type(frame),
         _bools(frame),
-        _arguments(frame)
+        _received(frame),
+        _arguments(_received)
     {}
 
     /**
@@ -10,13 +10,34 @@
  */
 namespace AMQP {
 
+/**
+ *  Helper function to construct a field from a frame in a buffer, or on the
+ *  heap if the buffer is too small
+ *  @param  frame
+ *  @param  buffer
+ *  @param  size
+ *  @return Field*
+ */
+template <typename T>
+static Field *construct(ReceivedFrame &frame, void *buffer, size_t size)
+{
+    // construct in the buffer if there is enough room
+    if (sizeof(T) <= size) return new (buffer) T(frame);
+
+    // otherwise we need a heap allocation
+    return new T(frame);
+}
+
 /**
  *  Decode a field by fetching a type and full field from a frame
- *  The returned field is allocated on the heap!
+ *  The returned field is constructed in the buffer if it fits, and
+ *  allocated on the heap otherwise
  *  @param  frame
+ *  @param  buffer
+ *  @param  size
  *  @return Field*
  */
-Field *Field::decode(ReceivedFrame &frame)
+Field *Field::decode(ReceivedFrame &frame, void *buffer, size_t size)
 {
     // get the type
     uint8_t type = frame.nextUint8();
@@ -24,23 +45,23 @@ Field *Field::decode(ReceivedFrame &frame)
     // create field based on type
     switch (type)
     {
-        case 't':   return new BooleanSet(frame);
-        case 'b':   return new Octet(frame);
-        case 'B':   return new UOctet(frame);
-        case 'U':   return new Short(frame);
-        case 'u':   return new UShort(frame);
-        case 'I':   return new Long(frame);
-        case 'i':   return new ULong(frame);
-        case 'L':   return new LongLong(frame);
-        case 'l':   return new ULongLong(frame);
-        case 'f':   return new Float(frame);
-        case 'd':   return new Double(frame);
-        case 'D':   return new DecimalField(frame);
-        case 's':   return new ShortString(frame);
-        case 'S':   return new LongString(frame);
-        case 'A':   return new Array(frame);
-        case 'T':   return new Timestamp(frame);
-        case 'F':   return new Table(frame);
+        case 't':   return construct<BooleanSet>(frame, buffer, size);
+        case 'b':   return construct<Octet>(frame, buffer, size);
+        case 'B':   return construct<UOctet>(frame, buffer, size);
+        case 'U':   return construct<Short>(frame, buffer, size);
+        case 'u':   return construct<UShort>(frame, buffer, size);
+        case 'I':   return construct<Long>(frame, buffer, size);
+        case 'i':   return construct<ULong>(frame, buffer, size);
+        case 'L':   return construct<LongLong>(frame, buffer, size);
+        case 'l':   return construct<ULongLong>(frame, buffer, size);
+        case 'f':   return construct<Float>(frame, buffer, size);
+        case 'd':   return construct<Double>(frame, buffer, size);
+        case 'D':   return construct<DecimalField>(frame, buffer, size);
+        case 's':   return construct<ShortString>(frame, buffer, size);
+        case 'S':   return construct<LongString>(frame, buffer, size);
+        case 'A':   return construct<Array>(frame, buffer, size);
+        case 'T':   return construct<Timestamp>(frame, buffer, size);
+        case 'F':   return construct<Table>(frame, buffer, size);
         default:    return nullptr;
     }
 }
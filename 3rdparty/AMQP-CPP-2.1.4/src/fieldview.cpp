@@ -0,0 +1,87 @@
+/**
+ *  FieldView.cpp
+ *
+ *  @copyright 2014 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Helper function to read the size that precedes strings, tables and arrays
+ *  @param  data
+ *  @return uint32_t
+ */
+static uint32_t readSize(const char *data)
+{
+    uint32_t size;
+    memcpy(&size, data, sizeof(size));
+    return be32toh(size);
+}
+
+/**
+ *  Size of an encoded value of a certain type
+ *  @param  type        the type ID
+ *  @param  data        the encoded value
+ *  @param  available   number of bytes available in the buffer
+ *  @return uint32_t    the size, or 0 if the value is invalid or does not fit
+ */
+uint32_t FieldView::measure(char type, const char *data, uint32_t available)
+{
+    // the size of the value
+    uint64_t size;
+
+    // check the type
+    switch (type)
+    {
+        case 't':
+        case 'b':
+        case 'B':   size = 1; break;
+        case 'U':
+        case 'u':   size = 2; break;
+        case 'I':
+        case 'i':
+        case 'f':   size = 4; break;
+        case 'D':   size = 5; break;
+        case 'L':
+        case 'l':
+        case 'd':
+        case 'T':   size = 8; break;
+        case 's':   size = available < 1 ? 0 : 1 + (uint8_t)data[0]; break;
+        case 'S':
+        case 'A':
+        case 'F':   size = available < 4 ? 0 : 4 + (uint64_t)readSize(data); break;
+        default:    size = 0; break;
+    }
+
+    // the value should fit in the buffer
+    return size <= available ? size : 0;
+}
+
+/**
+ *  Get the value as a nested table
+ *  @return TableView
+ */
+TableView FieldView::table() const
+{
+    // only for tables
+    return _type == 'F' ? TableView(_data, _size) : TableView();
+}
+
+/**
+ *  Get the value as a nested array
+ *  @return ArrayView
+ */
+ArrayView FieldView::array() const
+{
+    // only for arrays
+    return _type == 'A' ? ArrayView(_data, _size) : ArrayView();
+}
+
+/**
+ *  End of namespace
+ */
+}
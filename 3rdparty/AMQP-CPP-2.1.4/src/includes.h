@@ -10,6 +10,16 @@
 // include the generic amqp functions
 #include "../amqpcpp.h"
 
+// system includes for reading from file descriptors
+#include <unistd.h>
+#include <errno.h>
+
+// system includes for the worker threads of the dispatcher
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
 // classes that are very commonly used
 #include "exception.h"
 #include "protocolexception.h"
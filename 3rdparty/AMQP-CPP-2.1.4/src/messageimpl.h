@@ -25,30 +25,170 @@ private:
     uint64_t _received;
 
     /**
-     *  Was the buffer allocated by us?
-     *  @var bool
+     *  Buffer that we allocated ourselves for bodies that span multiple frames
+     *  @var char*
      */
-    bool _selfAllocated;
+    char *_buffer;
+
+    /**
+     *  Size of the self allocated buffer
+     *  @var uint64_t
+     */
+    uint64_t _capacity;
+
+    /**
+     *  The pool from which the buffer is allocated (may be empty)
+     *  @var std::shared_ptr<BufferPool>
+     */
+    std::shared_ptr<BufferPool> _pool;
+
+    /**
+     *  Give the self allocated buffer back
+     */
+    void release()
+    {
+        // nothing to do if we have no buffer
+        if (!_buffer) return;
+
+        // give it back to the pool, or free it ourselves
+        if (_pool) _pool->release(_buffer, _capacity);
+        else delete[] _buffer;
+
+        // we no longer have it
+        _buffer = nullptr;
+        _capacity = 0;
+    }
+
+    /**
+     *  Make sure that a buffer is allocated that is big enough for the body
+     */
+    void allocate()
+    {
+        // the buffer from an earlier message could be big enough
+        if (_capacity >= _bodySize) return;
+
+        // the buffer from an earlier message is too small
+        release();
+
+        // allocate a new buffer
+        if (_pool)
+        {
+            _buffer = _pool->allocate(_bodySize, _capacity);
+        }
+        else
+        {
+            _buffer = new char[_bodySize];
+            _capacity = _bodySize;
+        }
+    }
+
+    /**
+     *  Copy segments of a body into our own buffer, which must be big enough
+     *  @param  segments
+     */
+    void gather(const std::vector<Segment> &segments)
+    {
+        uint64_t offset = 0;
+        for (auto &segment : segments)
+        {
+            memcpy(_buffer + offset, segment.data, segment.size);
+            offset += segment.size;
+        }
+    }
+
+    /**
+     *  Copy the segments of the body into our own buffer
+     */
+    void flatten()
+    {
+        // make sure we have room
+        allocate();
+
+        // copy the segments
+        gather(_segments);
+
+        // the body is stored in our own buffer now
+        _body = _buffer;
+    }
 
 protected:
     /**
      *  Constructor
+     *  @param  pool        pool for the buffers of multi-frame bodies
      *  @param  exchange
      *  @param  routingKey
+     *  @param  consumerTag
      */
-    MessageImpl(const std::string &exchange, const std::string &routingKey) :
-        Message(exchange, routingKey),
-        _received(0), _selfAllocated(false)
+    MessageImpl(const std::shared_ptr<BufferPool> &pool, const StringView &exchange, const StringView &routingKey, const StringView &consumerTag = StringView()) :
+        Message(exchange, routingKey, consumerTag),
+        _received(0), _buffer(nullptr), _capacity(0), _pool(pool)
         {}
 
+    /**
+     *  Constructor for messages that do not use a pool
+     *  @param  exchange
+     *  @param  routingKey
+     *  @param  consumerTag
+     */
+    MessageImpl(const StringView &exchange, const StringView &routingKey, const StringView &consumerTag = StringView()) :
+        MessageImpl(nullptr, exchange, routingKey, consumerTag) {}
+
+    /**
+     *  Reset the message so that the object can be reused for a new delivery
+     *
+     *  The capacity of the strings is kept, so that recycled messages do not
+     *  have to allocate memory again. A pooled body buffer goes back to the
+     *  pool, so that idle messages do not hold on to memory that other
+     *  messages of the connection could use.
+     *
+     *  @param  exchange
+     *  @param  routingKey
+     *  @param  consumerTag
+     */
+    void reset(const StringView &exchange, const StringView &routingKey, const StringView &consumerTag = StringView())
+    {
+        // refer to the new strings (they are only copied when necessary)
+        _exchange = exchange;
+        _routingKey = routingKey;
+        _consumerTag = consumerTag;
+
+        // forget the previous body
+        if (_pool) release();
+        _segments.clear();
+        _body = nullptr;
+        _bodySize = 0;
+        _received = 0;
+    }
+
 public:
+    /**
+     *  Make sure that the message no longer refers to the input buffer
+     */
+    void preserve()
+    {
+        // copy the strings
+        Message::preserve();
+
+        // a body that is still being received is copied into our own buffer,
+        // when the message is complete it no longer needs the body
+        if (!_body && !_segments.empty() && _received < _bodySize) flatten();
+
+        // the segments refer to the input buffer
+        _segments.clear();
+    }
+
+    /**
+     *  Store the raw properties from the header frame
+     */
+    using Message::setEncoded;
+
     /**
      *  Destructor
      */
     virtual ~MessageImpl()
     {
         // clear up memory if it was self allocated
-        if (_selfAllocated) delete[] _body;
+        release();
     }
 
     /**
@@ -61,42 +201,134 @@ public:
         _bodySize = size;
     }
 
+    /**
+     *  Register data that was passed on to a streaming consumer, instead
+     *  of being stored in the message
+     *  @param  size        size of the data
+     *  @return bool        true if the message is now complete
+     */
+    bool skip(uint64_t size)
+    {
+        // we have more data now
+        _received += size;
+
+        // done
+        return _received >= _bodySize;
+    }
+
+    /**
+     *  Has all data of the body been received?
+     *  @return bool
+     */
+    bool complete() const
+    {
+        return _received >= _bodySize;
+    }
+
+    /**
+     *  Take over the contents of a complete message, so that it can be kept
+     *  after the callback, and used in other threads
+     *
+     *  The body buffer is moved when the other message has one of its own,
+     *  otherwise the body is copied out of the input buffer. The other message
+     *  stays with the channel, it no longer has a body after this call.
+     *
+     *  The properties are decoded right away, so that reading them later
+     *  does not modify the object (see OwnedMessage for the exceptions).
+     *
+     *  @param  that        the message to take over
+     */
+    void take(MessageImpl &that)
+    {
+        // copy the strings and the properties
+        Message::preserve();
+        MetaData::set(that);
+
+        // decode the properties now, and not in the thread that reads them
+        decode();
+
+        // we have the whole body
+        _bodySize = _received = that._bodySize;
+
+        // is the body in a buffer of the other message?
+        if (that._body && that._body == that._buffer)
+        {
+            // take the buffer, it is freed normally because we have no pool
+            std::swap(_buffer, that._buffer);
+            std::swap(_capacity, that._capacity);
+            _body = _buffer;
+        }
+        else if (_bodySize > 0)
+        {
+            // make room for the data
+            allocate();
+
+            // copy the data from the input buffer, or the segments
+            if (that._body) memcpy(_buffer, that._body, _bodySize);
+            else gather(that._segments);
+
+            // the body is stored in our own buffer now
+            _body = _buffer;
+        }
+
+        // the other message has no body anymore
+        that._body = nullptr;
+        that._segments.clear();
+    }
+
+    /**
+     *  Access to the full message data, the segments are copied into one
+     *  buffer when the body was received in multiple frames
+     *  @return buffer
+     */
+    virtual const char *body() const override
+    {
+        // the message is never really constant, it is owned by the channel
+        if (!_body && !_segments.empty()) const_cast<MessageImpl*>(this)->flatten();
+
+        // done
+        return _body;
+    }
+
     /**
      *  Append data
+     *
+     *  Data that is received in multiple frames is not copied, but stored as
+     *  segments that refer to the frames. Only when the frames are about to
+     *  go away (see preserve()), or when the body is asked for in one piece,
+     *  the segments are copied into our own buffer.
+     *
      *  @param  buffer      incoming data
      *  @param  size        size of the data
      *  @return bool        true if the message is now complete
      */
     bool append(const char *buffer, uint64_t size)
     {
+        // prevent that size is too big
+        if (size > _bodySize - _received) size = _bodySize - _received;
+
         // is this the only data, and also direct complete?
         if (_received == 0 && size >= _bodySize)
         {
             // we have everything
             _body = buffer;
-            _received = _bodySize;
-
-            // done
-            return true;
+        }
+        else if (_body)
+        {
+            // the earlier data was already copied into our own buffer
+            memcpy(_buffer + _received, buffer, size);
         }
         else
         {
-            // it does not yet fit, do we have to allocate?
-            if (!_body) _body = new char[_bodySize];
-            _selfAllocated = true;
-
-            // prevent that size is too big
-            if (size > _bodySize - _received) size = _bodySize - _received;
-
-            // append data
-            memcpy((char *)(_body + _received), buffer, size);
+            // refer to the frame
+            _segments.emplace_back(buffer, size);
+        }
 
-            // we have more data now
-            _received += size;
+        // we have more data now
+        _received += size;
 
-            // done
-            return _received >= _bodySize;
-        }
+        // done
+        return _received >= _bodySize;
     }
 };
 
@@ -104,4 +336,3 @@ public:
  *  End of namespace
  */
 }
-
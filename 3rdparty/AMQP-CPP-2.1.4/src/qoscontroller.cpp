@@ -0,0 +1,214 @@
+/**
+ *  QosController.cpp
+ *
+ *  Implementation file for the QosController class
+ *
+ *  @copyright 2014 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Namespace
+ */
+namespace AMQP {
+
+/**
+ *  Weight of a new measurement in the averages, like the smoothed
+ *  round trip time of TCP
+ *  @var double
+ */
+static const double weight = 0.125;
+
+/**
+ *  Add a measurement to an average
+ *  @param  average
+ *  @param  value
+ */
+static void measure(double &average, double value)
+{
+    // the first measurement is taken as it is
+    if (average == 0.0) average = value;
+    else average += weight * (value - average);
+}
+
+/**
+ *  Constructor
+ *  @param  channel     the channel that consumes the messages
+ *  @param  minimum     lowest prefetch count to use
+ *  @param  maximum     highest prefetch count to use
+ *  @param  limit       maximum bytes in unacknowledged messages, zero for no limit
+ */
+QosController::QosController(Channel *channel, uint16_t minimum, uint16_t maximum, uint64_t limit) :
+    _channel(channel),
+    _minimum(std::max<uint16_t>(minimum, 1)),
+    _maximum(std::max(maximum, _minimum)),
+    _limit(limit),
+    _lastAck(Clock::now()),
+    _prefetch(_minimum)
+{
+    // start with the minimum, this also gives the first round trip time
+    send(_minimum);
+}
+
+/**
+ *  Send a new prefetch count to the server
+ *  @param  prefetch
+ */
+void QosController::send(uint16_t prefetch)
+{
+    // remember what we sent
+    _prefetch = prefetch;
+    _pending = true;
+    _sent = Clock::now();
+
+    // the answer could come after we are destructed
+    auto monitor = std::make_shared<Monitor>(this);
+
+    // send the instruction for the whole channel, a per-consumer count
+    // would not change the consumers that are already running, the answer
+    // gives the round trip time
+    _channel->setQos(prefetch, true).onSuccess([this, monitor]() {
+
+        // leap out if we no longer exist
+        if (!monitor->valid()) return;
+
+        // measure the round trip
+        measure(_latency, std::chrono::duration<double>(Clock::now() - _sent).count());
+
+        // the traffic could have changed in the meantime
+        _pending = false;
+        adjust();
+
+    }).onError([this, monitor](const char *) {
+
+        // the channel is no longer usable, so we do not send anything more
+        if (monitor->valid()) _pending = false;
+    });
+}
+
+/**
+ *  Calculate the prefetch count to use, and send it when it is different
+ */
+void QosController::adjust()
+{
+    // wait for the answer to the previous instruction
+    if (_pending) return;
+
+    // when too many bytes are underway, the server should stop delivering
+    // until messages are acked, which is what a prefetch count of one does
+    // as long as at least one message is not yet acked
+    _paused = _limit > 0 && _bytes >= _limit;
+    if (_paused)
+    {
+        if (_prefetch != 1) send(1);
+        return;
+    }
+
+    // we need measurements to do anything
+    if (_processing == 0.0) return;
+
+    // enough messages to keep us busy during a round trip, plus the one we work on
+    double target = std::ceil(_latency / _processing) + 1.0;
+
+    // and no more than would fit in the byte limit
+    if (_limit > 0 && _size > 0.0) target = std::min(target, std::max(1.0, std::floor(_limit / _size)));
+
+    // stay within the bounds
+    uint16_t prefetch = (uint16_t)std::max<double>(_minimum, std::min<double>(_maximum, target));
+
+    // small changes are not worth a round trip (during which acks are held back)
+    if (_prefetch != 1 && std::abs(prefetch - _prefetch) * 4 <= _prefetch) return;
+    if (prefetch == _prefetch) return;
+
+    // send the new count
+    send(prefetch);
+}
+
+/**
+ *  Forget about acknowledged or rejected messages
+ *  @param  deliveryTag
+ *  @param  flags
+ */
+void QosController::remove(uint64_t deliveryTag, int flags)
+{
+    // the messages to remove, all earlier ones too for the multiple flag
+    auto begin = _deliveries.begin();
+    auto end = _deliveries.upper_bound(deliveryTag);
+
+    // or just the one message
+    if (!(flags & multiple))
+    {
+        begin = _deliveries.find(deliveryTag);
+        if (begin != _deliveries.end()) end = std::next(begin);
+        else end = begin;
+    }
+
+    // nothing to do for unknown messages
+    if (begin == end) return;
+
+    // handling started when the message came in, or when the previous one was done
+    auto now = Clock::now();
+    auto start = std::max(_lastAck, std::prev(end)->second.received);
+    _lastAck = now;
+
+    // the time per message, when acking multiple messages they were handled together
+    measure(_processing, std::chrono::duration<double>(now - start).count() / std::distance(begin, end));
+
+    // forget the messages
+    for (auto iter = begin; iter != end; ++iter) _bytes -= iter->second.size;
+    _deliveries.erase(begin, end);
+}
+
+/**
+ *  Report that a message was received
+ *  @param  deliveryTag     delivery tag of the message
+ *  @param  size            size of the message body
+ */
+void QosController::received(uint64_t deliveryTag, uint64_t size)
+{
+    // remember the message
+    _deliveries[deliveryTag] = Delivery{ size, Clock::now() };
+    _bytes += size;
+    measure(_size, size);
+
+    // pause when we exceed the byte limit
+    adjust();
+}
+
+/**
+ *  Acknowledge a message
+ *  @param  deliveryTag     the delivery tag of the message
+ *  @param  flags           optional flags
+ *  @return bool
+ */
+bool QosController::ack(uint64_t deliveryTag, int flags)
+{
+    // forget the message, and recalculate before acking, so that the server
+    // does not deliver more than we want after the ack
+    remove(deliveryTag, flags);
+    adjust();
+
+    // send the ack
+    return _channel->ack(deliveryTag, flags);
+}
+
+/**
+ *  Reject a message
+ *  @param  deliveryTag     the delivery tag of the message
+ *  @param  flags           optional flags
+ *  @return bool
+ */
+bool QosController::reject(uint64_t deliveryTag, int flags)
+{
+    // forget the message
+    remove(deliveryTag, flags);
+    adjust();
+
+    // send the reject
+    return _channel->reject(deliveryTag, flags);
+}
+
+/**
+ *  End of namespace
+ */
+}
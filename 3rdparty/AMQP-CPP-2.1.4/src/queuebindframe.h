@@ -45,11 +45,19 @@ private:
      */
     BooleanSet _noWait;
 
+    /**
+     *  Storage for the table of a received frame
+     *  @var Table
+     */
+    Table _received;
+
     /**
      *  Additional arguments. Implementation dependent.
+     *  The table is not copied: outgoing frames refer to the table that was passed
+     *  to the constructor, received frames to their own decoded copy
      *  @var Table
      */
-    Table _arguments;
+    const Table &_arguments;
 
 protected:
     /**
@@ -107,7 +115,8 @@ public:
         _exchange(frame),
         _routingKey(frame),
         _noWait(frame),
-        _arguments(frame)
+        _received(frame),
+        _arguments(_received)
     {}
 
     /**
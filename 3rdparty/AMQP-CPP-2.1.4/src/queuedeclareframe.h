@@ -38,11 +38,19 @@ private:
      */
     BooleanSet _bools;
 
+    /**
+     *  Storage for the table of a received frame
+     *  @var Table
+     */
+    Table _received;
+
     /**
      *  Additional arguments. Implementation dependant.
+     *  The table is not copied: outgoing frames refer to the table that was passed
+     *  to the constructor, received frames to their own decoded copy
      *  @var Table
      */
-    Table _arguments;
+    const Table &_arguments;
 
 protected:
     /**
@@ -95,7 +103,8 @@ public:
         _deprecated(frame.nextInt16()),
         _name(frame),
         _bools(frame),
-        _arguments(frame)
+        _received(frame),
+        _arguments(_received)
     {}
 
     /**
@@ -17,10 +17,12 @@
 #include "connectiontuneframe.h"
 #include "connectioncloseokframe.h"
 #include "connectioncloseframe.h"
+#include "connectionblockedframe.h"
+#include "connectionunblockedframe.h"
 #include "channelopenframe.h"
 #include "channelopenokframe.h"
-#include "channelflowframe.h"
 #include "channelflowokframe.h"
+#include "channelflowframe.h"
 #include "channelcloseokframe.h"
 #include "channelcloseframe.h"
 #include "exchangedeclareframe.h"
@@ -289,6 +291,19 @@ const char * ReceivedFrame::nextData(uint32_t size)
     return _buffer.data(_skip, size);
 }
 
+/**
+ *  Get a view on the next short string, without copying it
+ *  @return StringView
+ */
+StringView ReceivedFrame::nextShortString()
+{
+    // the size of the string
+    uint8_t size = nextUint8();
+
+    // the view refers to the data in the buffer
+    return StringView(nextData(size), size);
+}
+
 /**
  *  Process the received frame
  *  @param  connection
@@ -319,6 +334,10 @@ bool ReceivedFrame::processMethodFrame(ConnectionImpl *connection)
 {
     // read the class id from the method
     uint16_t classID = nextUint16();
+
+    // messages that were collected for batch consumers are reported before
+    // anything else happens on the channel (basic methods are checked later)
+    if (classID != 60 && !connection->reportBatch(_channel)) return false;
     
     // construct frame based on method id
     switch (classID)
@@ -358,6 +377,8 @@ bool ReceivedFrame::processConnectionFrame(ConnectionImpl *connection)
         case 41:    return ConnectionOpenOKFrame(*this).process(connection);
         case 50:    return ConnectionCloseFrame(*this).process(connection);
         case 51:    return ConnectionCloseOKFrame(*this).process(connection);
+        case 60:    return ConnectionBlockedFrame(*this).process(connection);
+        case 61:    return ConnectionUnblockedFrame(*this).process(connection);
     }
 
     // this is a problem
@@ -458,6 +479,10 @@ bool ReceivedFrame::processBasicFrame(ConnectionImpl *connection)
     // read the method id from the method
     uint16_t methodID = nextUint16();
 
+    // messages for batch consumers are reported before other methods, so that
+    // for example a cancelled consumer still gets the messages it was sent
+    if (methodID != 60 && !connection->reportBatch(_channel)) return false;
+
     // construct frame based on method id
     switch (methodID)
     {
@@ -39,7 +39,11 @@ public:
      */
     ReturnedMessage(const BasicReturnFrame &frame) :
         MessageImpl(frame.exchange(), frame.routingKey()),
-        _replyCode(frame.replyCode()), _replyText(frame.replyText()) {}
+        _replyCode(frame.replyCode()), _replyText(frame.replyText())
+    {
+        // the strings refer to the frame, so we need our own copy
+        preserve();
+    }
 
     /**
      *  Destructor
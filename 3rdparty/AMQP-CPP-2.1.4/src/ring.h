@@ -0,0 +1,136 @@
+/**
+ *  Ring.h
+ *
+ *  Lock free queue with a fixed capacity, for a single thread that pushes
+ *  values and a single other thread that pops them.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+template <typename T>
+class Ring
+{
+private:
+    /**
+     *  The slots, the number of slots is a power of two
+     *  @var std::vector<T>
+     */
+    std::vector<T> _slots;
+
+    /**
+     *  Mask to turn a position into an index
+     *  @var size_t
+     */
+    size_t _mask;
+
+    /**
+     *  Position of the next value to pop, only changed by the consumer
+     *  (the positions are padded to keep them on their own cache lines, so
+     *  that the threads do not slow each other down; alignas() is not used,
+     *  because before C++17 operator new ignores it for heap objects)
+     *  @var std::atomic<size_t>
+     */
+    std::atomic<size_t> _head;
+    char _headPadding[64 - sizeof(std::atomic<size_t>)];
+
+    /**
+     *  Position of the next value to push, only changed by the producer
+     *  @var std::atomic<size_t>
+     */
+    std::atomic<size_t> _tail;
+    char _tailPadding[64 - sizeof(std::atomic<size_t>)];
+
+    /**
+     *  Round a capacity up to a power of two
+     *  @param  capacity
+     *  @return size_t
+     */
+    static size_t round(size_t capacity)
+    {
+        size_t result = 1;
+        while (result < capacity) result <<= 1;
+        return result;
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  capacity    minimum number of values that fit in the ring
+     */
+    Ring(size_t capacity) : _slots(round(capacity)), _mask(_slots.size() - 1), _head(0), _tail(0) {}
+
+    /**
+     *  The ring can not be copied
+     *  @param  that
+     */
+    Ring(const Ring &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~Ring() {}
+
+    /**
+     *  Add a value, only to be called by the producer
+     *  @param  value
+     *  @return bool        false if the ring is full
+     */
+    bool push(T &&value)
+    {
+        // the position to write to
+        size_t tail = _tail.load(std::memory_order_relaxed);
+
+        // check if there is room
+        if (tail - _head.load(std::memory_order_acquire) >= _slots.size()) return false;
+
+        // store the value, and publish it to the consumer
+        _slots[tail & _mask] = std::move(value);
+        _tail.store(tail + 1, std::memory_order_release);
+
+        // done
+        return true;
+    }
+
+    /**
+     *  Remove a value, only to be called by the consumer
+     *  @param  value       the value is moved into this object
+     *  @return bool        false if the ring is empty
+     */
+    bool pop(T &value)
+    {
+        // the position to read from
+        size_t head = _head.load(std::memory_order_relaxed);
+
+        // check if there is a value
+        if (head == _tail.load(std::memory_order_acquire)) return false;
+
+        // take the value, and give the slot back to the producer
+        value = std::move(_slots[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+
+        // done
+        return true;
+    }
+
+    /**
+     *  Is the ring empty?
+     *  @return bool
+     */
+    bool empty() const
+    {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
@@ -10,27 +10,32 @@ namespace AMQP {
  */
 Table::Table(ReceivedFrame &frame)
 {
-    // table buffer begins with the number of bytes to read 
+    // table buffer begins with the number of bytes to read
     uint32_t bytesToRead = frame.nextUint32();
-    
-    // keep going until the correct number of bytes is read. 
+
+    // keep going until the correct number of bytes is read.
     while (bytesToRead > 0)
     {
         // field name and type
-        ShortString name(frame);
-        
-        // subtract number of bytes to read, plus one byte for the decoded type
-        bytesToRead -= (name.size() + 1);
-        
-        // get the field
-        Field *field = Field::decode(frame);
-        if (!field) continue;
-        
-        // add field
-        _fields[name] = std::shared_ptr<Field>(field);
-        
+        StringView name = frame.nextShortString();
+
+        // subtract number of bytes to read, plus one byte for the size and one byte for the decoded type
+        bytesToRead -= (name.size() + 2);
+
+        // find the position of the field (tables are normally sent in sorted order,
+        // so this is almost always the end)
+        size_t pos = position(name);
+
+        // decode the field
+        FieldValue value(frame);
+        if (!value.valid()) continue;
+
         // subtract size
-        bytesToRead -= field->size();
+        bytesToRead -= value->size();
+
+        // add or replace the field
+        if (matches(pos, name)) _fields[pos].second = std::move(value);
+        else _fields.emplace(_fields.begin() + pos, std::string(name.data(), name.size()), std::move(value));
     }
 }
 
@@ -38,15 +43,7 @@ Table::Table(ReceivedFrame &frame)
  *  Copy constructor
  *  @param  table
  */
-Table::Table(const Table &table)
-{
-    // loop through the table records
-    for (auto iter = table._fields.begin(); iter != table._fields.end(); iter++)
-    {
-        // add the field
-        _fields[iter->first] = std::shared_ptr<Field>(iter->second->clone());
-    }
-}
+Table::Table(const Table &table) : _fields(table._fields) {}
 
 /**
  *  Assignment operator
@@ -57,21 +54,14 @@ Table &Table::operator=(const Table &table)
 {
     // skip self assignment
     if (this == &table) return *this;
-    
-    // empty current fields
-    _fields.clear();
-    
-    // loop through the table records
-    for (auto iter = table._fields.begin(); iter != table._fields.end(); iter++)
-    {
-        // add the field
-        _fields[iter->first] = std::shared_ptr<Field>(iter->second->clone());
-    }
-    
+
+    // copy the fields
+    _fields = table._fields;
+
     // done
     return *this;
 }
-    
+
 /**
  *  Move assignment operator
  *  @param  table
@@ -81,35 +71,89 @@ Table &Table::operator=(Table &&table)
 {
     // skip self assignment
     if (this == &table) return *this;
-    
+
     // copy fields
     _fields = std::move(table._fields);
-    
+
+    // done
+    return *this;
+}
+
+/**
+ *  Find the position of a field, or the position where it should be inserted
+ *  @param  name    field name
+ *  @return size_t
+ */
+size_t Table::position(const StringView &name) const
+{
+    // fields are normally added in sorted order, so check the end first
+    if (_fields.empty() || _fields.back().first.compare(0, std::string::npos, name.data(), name.size()) < 0) return _fields.size();
+
+    // binary search for the first field that is not smaller
+    auto iter = std::lower_bound(_fields.begin(), _fields.end(), name, [](const FieldMap::value_type &field, const StringView &name) {
+        return field.first.compare(0, std::string::npos, name.data(), name.size()) < 0;
+    });
+
     // done
+    return iter - _fields.begin();
+}
+
+/**
+ *  Set a field
+ *
+ *  @param  name    field name
+ *  @param  value   field value
+ *  @return Table
+ */
+Table &Table::set(const StringView &name, const Field &value)
+{
+    // find the position
+    size_t pos = position(name);
+
+    // replace an existing field
+    if (matches(pos, name))
+    {
+        // overwrite the value
+        _fields[pos].second = value;
+    }
+    else if ((const void *)&value >= (const void *)_fields.data() && (const void *)&value < (const void *)(_fields.data() + _fields.size()))
+    {
+        // the value is stored in this table, and could move when the field is
+        // inserted, so we need a copy first
+        FieldValue copy(value);
+        _fields.emplace(_fields.begin() + pos, std::string(name.data(), name.size()), std::move(copy));
+    }
+    else
+    {
+        // insert a new field
+        _fields.emplace(_fields.begin() + pos, std::string(name.data(), name.size()), value);
+    }
+
+    // allow chaining
     return *this;
 }
 
 /**
  *  Get a field
- * 
+ *
  *  If the field does not exist, an empty string field is returned
  *
  *  @param  name    field name
  *  @return         the field value
  */
-const Field &Table::get(const std::string &name) const
+const Field &Table::get(const StringView &name) const
 {
     // we need an empty string
     static ShortString empty;
-    
+
     // locate the element first
-    auto iter(_fields.find(name));
+    size_t pos = position(name);
 
     // check whether the field was found
-    if (iter == _fields.end()) return empty;
+    if (!matches(pos, name)) return empty;
 
     // done
-    return *iter->second;
+    return *_fields[pos].second;
 }
 
 /**
@@ -122,17 +166,16 @@ size_t Table::size() const
     size_t size = 4;
 
     // iterate over all elements
-    for (auto iter(_fields.begin()); iter != _fields.end(); ++iter)
+    for (auto &field : _fields)
     {
-        // get the size of the field name
-        ShortString name(iter->first);
-        size += name.size();
+        // add the size of the field name (and its size byte)
+        size += 1 + field.first.size();
 
         // add the size of the field type
-        size += sizeof(iter->second->typeID());
+        size += sizeof(field.second->typeID());
 
         // add size of element to the total
-        size += iter->second->size();
+        size += field.second->size();
     }
 
     // return the result
@@ -140,25 +183,25 @@ size_t Table::size() const
 }
 
 /**
- *  Write encoded payload to the given buffer. 
+ *  Write encoded payload to the given buffer.
  */
 void Table::fill(OutBuffer& buffer) const
 {
     // add size
-    buffer.add(static_cast<uint32_t>(size()-4));
+    buffer.add(static_cast<uint32_t>(Table::size()-4));
 
     // loop through the fields
-    for (auto iter(_fields.begin()); iter != _fields.end(); ++iter)
+    for (auto &field : _fields)
     {
         // encode the field name
-        ShortString name(iter->first);
-        name.fill(buffer);
-        
+        buffer.add((uint8_t) field.first.size());
+        buffer.add(field.first.data(), field.first.size());
+
         // encode the element type
-        buffer.add((uint8_t) iter->second->typeID());
+        buffer.add((uint8_t) field.second->typeID());
 
         // encode element
-        iter->second->fill(buffer);
+        field.second->fill(buffer);
     }
 }
 
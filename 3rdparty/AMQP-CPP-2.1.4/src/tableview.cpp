@@ -0,0 +1,127 @@
+/**
+ *  TableView.cpp
+ *
+ *  @copyright 2014 Copernica BV
+ */
+#include "includes.h"
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Construct a view on an encoded table
+ *  @param  data    the encoded table, starting with the size
+ *  @param  size    number of bytes available
+ */
+TableView::TableView(const char *data, size_t size) : TableView()
+{
+    // the table starts with its size
+    if (size < 4) return;
+    uint32_t length = FieldView('i', data, 4).integer();
+
+    // the fields should fit in the buffer
+    if (length > size - 4) return;
+
+    // store the fields
+    _data = data;
+    _size = length;
+}
+
+/**
+ *  Construct a view on a table that was received in a frame
+ *  @param  frame
+ */
+TableView::TableView(ReceivedFrame &frame) : _size(frame.nextUint32())
+{
+    // the fields follow the size
+    _data = frame.nextData(_size) - 4;
+}
+
+/**
+ *  Parse the field at the current position
+ */
+void TableView::iterator::parse()
+{
+    // nothing left?
+    if (_pos == _end) return;
+
+    // number of bytes available
+    uint32_t available = _end - _pos;
+
+    // the name, followed by the type
+    uint8_t length = _pos[0];
+    if (available < 2u + length) { _pos = _end; return; }
+
+    // the value follows the type
+    char type = _pos[1 + length];
+    const char *data = _pos + 2 + length;
+    uint32_t size = FieldView::measure(type, data, _end - data);
+
+    // stop at invalid values
+    if (size == 0) { _pos = _end; return; }
+
+    // store the field
+    _name = StringView(_pos + 1, length);
+    _value = FieldView(type, data, size);
+}
+
+/**
+ *  Look up a field
+ *  @param  name    field name
+ *  @return FieldView
+ */
+FieldView TableView::get(const StringView &name) const
+{
+    // walk over all fields
+    for (auto &field : *this)
+    {
+        // is this the field we're looking for?
+        if (field.name() == name) return field.value();
+    }
+
+    // not found
+    return FieldView();
+}
+
+/**
+ *  Can all fields be parsed, including those of nested tables and arrays?
+ *  @return bool
+ */
+bool TableView::valid() const
+{
+    // number of bytes used by the fields that could be parsed
+    uint32_t size = 0;
+
+    // walk over all fields
+    for (auto &field : *this)
+    {
+        // nested tables and arrays should be valid too
+        if (field.value().isTable() && !field.value().table().valid()) return false;
+        if (field.value().isArray() && !field.value().array().valid()) return false;
+
+        // the name (size byte included), the type and the value
+        size += 2 + field.name().size() + field.value().size();
+    }
+
+    // iterating stops at the first invalid field, so it should not have left bytes behind
+    return size == _size;
+}
+
+/**
+ *  Decode the table into a table object
+ *  @return Table
+ */
+Table TableView::decode() const
+{
+    // decode the table, size included
+    ByteBuffer buffer(_data, _size + 4);
+    ReceivedFrame frame(buffer);
+    return Table(frame);
+}
+
+/**
+ *  End of namespace
+ */
+}
@@ -0,0 +1,98 @@
+/**
+ *  Upload.h
+ *
+ *  The body of a streaming publish. The data is read with a callback, one
+ *  frame at a time, when the application asks for more output with the
+ *  Connection::pump() method.
+ *
+ *  @copyright 2014 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class Upload
+{
+private:
+    /**
+     *  Number of bytes that still have to be read
+     *  @var uint64_t
+     */
+    uint64_t _remaining;
+
+    /**
+     *  The callback that reads the data
+     *  @var ReadCallback
+     */
+    ReadCallback _reader;
+
+    /**
+     *  Buffer for the data of a single frame
+     *  @var std::vector<char>
+     */
+    std::vector<char> _buffer;
+
+public:
+    /**
+     *  Constructor
+     *  @param  size        size of the body
+     *  @param  reader      callback that reads the data
+     */
+    Upload(uint64_t size, const ReadCallback &reader) : _remaining(size), _reader(reader) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~Upload() {}
+
+    /**
+     *  Number of bytes that still have to be read
+     *  @return uint64_t
+     */
+    uint64_t remaining() const
+    {
+        return _remaining;
+    }
+
+    /**
+     *  The data that was read last
+     *  @return const char *
+     */
+    const char *data() const
+    {
+        return _buffer.data();
+    }
+
+    /**
+     *  Read the next part of the body
+     *  @param  max         maximum number of bytes to read
+     *  @return size_t      number of bytes read, zero if the body could not be read
+     */
+    size_t read(size_t max)
+    {
+        // do not read beyond the end of the body
+        size_t size = std::min<uint64_t>(max, _remaining);
+
+        // make room for the data
+        if (_buffer.size() < size) _buffer.resize(size);
+
+        // read the data, the reader may return less than asked for
+        size_t result = std::min(_reader(_buffer.data(), size), size);
+
+        // we have less data left now
+        _remaining -= result;
+
+        // done
+        return result;
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
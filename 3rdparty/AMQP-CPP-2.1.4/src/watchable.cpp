@@ -16,10 +16,10 @@ namespace AMQP {
 Watchable::~Watchable()
 {
     // loop through all monitors
-    for (auto iter = _monitors.begin(); iter != _monitors.end(); iter++)
+    for (Monitor *monitor = _monitors; monitor; monitor = monitor->_next)
     {
         // tell the monitor that it now is invalid
-        (*iter)->invalidate();
+        monitor->invalidate();
     }
 }
 
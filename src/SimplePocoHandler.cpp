@@ -68,6 +68,7 @@ struct SimplePocoHandlerImpl
 {
     SimplePocoHandlerImpl() :
             connected(false),
+            blocked(false),
             connection(nullptr),
             quit(false),
             inputBuffer(SimplePocoHandler::BUFFER_SIZE),
@@ -78,11 +79,13 @@ struct SimplePocoHandlerImpl
 
     Poco::Net::StreamSocket socket;
     bool connected;
+    bool blocked;
     AMQP::Connection* connection;
     bool quit;
     Buffer inputBuffer;
     Buffer outBuffer;
     std::vector<char> tmpBuff;
+    std::function<void()> tick;
 };
 SimplePocoHandler::SimplePocoHandler(const std::string& host, uint16_t port) :
         m_impl(new SimplePocoHandlerImpl)
@@ -103,8 +106,13 @@ void SimplePocoHandler::loop()
     {
         while (!m_impl->quit)
         {
+            // only sleep when there was nothing to read, so that parsing
+            // keeps up with the network when the handlers run in other threads
+            bool idle = true;
+
             if (m_impl->socket.available() > 0)
             {
+                idle = false;
                 size_t avail = m_impl->socket.available();
                 if(m_impl->tmpBuff.size()<avail)
                 {
@@ -132,9 +140,29 @@ void SimplePocoHandler::loop()
                     m_impl->inputBuffer.shl(count);
                 }
             }
-            sendDataFromBuffer();
+            if (m_impl->tick)
+            {
+                m_impl->tick();
+            }
+
+            // the server does not read from a blocked connection, so the
+            // data is kept in the buffer until the connection is unblocked
+            if (!m_impl->blocked)
+            {
+                sendDataFromBuffer();
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                // the output buffer is empty, so produce more of the bodies of
+                // streaming publishes
+                if (m_impl->connection && m_impl->connection->pump(TEMP_BUFFER_SIZE) > 0)
+                {
+                    sendDataFromBuffer();
+                }
+            }
+
+            if (idle)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
         }
 
         if (m_impl->quit && m_impl->outBuffer.available())
@@ -148,6 +176,11 @@ void SimplePocoHandler::loop()
     }
 }
 
+void SimplePocoHandler::onTick(const std::function<void()>& callback)
+{
+    m_impl->tick = callback;
+}
+
 void SimplePocoHandler::quit()
 {
     m_impl->quit = true;
@@ -165,6 +198,8 @@ void SimplePocoHandler::onData(
     const size_t writen = m_impl->outBuffer.write(data, size);
     if (writen != size)
     {
+        // the buffer is full, this is sent even when the connection is
+        // blocked (publishing fails then, so this does not grow)
         sendDataFromBuffer();
         m_impl->outBuffer.write(data + writen, size - writen);
     }
@@ -187,11 +222,29 @@ void SimplePocoHandler::onClosed(AMQP::Connection *connection)
     m_impl->quit  = true;
 }
 
+void SimplePocoHandler::onBlocked(
+        AMQP::Connection *connection, const char *reason)
+{
+    std::cerr<<"AMQP connection blocked "<<reason<<std::endl;
+    m_impl->blocked = true;
+}
+
+void SimplePocoHandler::onUnblocked(AMQP::Connection *connection)
+{
+    std::cerr<<"AMQP connection unblocked"<<std::endl;
+    m_impl->blocked = false;
+}
+
 bool SimplePocoHandler::connected() const
 {
     return m_impl->connected;
 }
 
+bool SimplePocoHandler::blocked() const
+{
+    return m_impl->blocked;
+}
+
 void SimplePocoHandler::sendDataFromBuffer()
 {
     if (m_impl->outBuffer.available())
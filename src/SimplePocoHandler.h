@@ -2,6 +2,7 @@
 #define SRC_SIMPLEPOCOHANDLER_H_
 
 #include <memory>
+#include <functional>
 #include <amqpcpp.h>
 
 class SimplePocoHandlerImpl;
@@ -18,7 +19,11 @@ public:
     void loop();
     void quit();
 
+    // called from the loop after the incoming data was parsed
+    void onTick(const std::function<void()>& callback);
+
     bool connected() const;
+    bool blocked() const;
 
 private:
 
@@ -36,6 +41,10 @@ private:
 
     virtual void onClosed(AMQP::Connection *connection);
 
+    virtual void onBlocked(AMQP::Connection *connection, const char *reason);
+
+    virtual void onUnblocked(AMQP::Connection *connection);
+
     void sendDataFromBuffer();
 
 private:
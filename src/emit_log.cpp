@@ -15,8 +15,15 @@ int main(int argc, const char* argv[])
     AMQP::Channel channel(&connection);
     channel.declareExchange("logs", AMQP::fanout).onSuccess([&]()
     {
-        channel.publish("logs", "", msg);
-        std::cout << " [x] Sent "<<msg<< std::endl;
+        // the server blocks publishing when it runs low on resources
+        if (channel.publish("logs", "", msg))
+        {
+            std::cout << " [x] Sent "<<msg<< std::endl;
+        }
+        else
+        {
+            std::cout << " [x] Not sent, publishing is blocked"<< std::endl;
+        }
         handler.quit();
     });
 
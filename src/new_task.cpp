@@ -16,10 +16,17 @@ int main(int argc, const char* argv[])
     AMQP::QueueCallback callback =
             [&](const std::string &name, int msgcount, int consumercount)
             {
-                AMQP::Envelope env(msg);
+                AMQP::Envelope env(msg.data(), msg.size());
                 env.setDeliveryMode(2);
-                channel.publish("", "task_queue", env);
-                std::cout<<" [x] Sent '"<<msg<<"'\n";
+                // the server blocks publishing when it runs low on resources
+                if (channel.publish("", "task_queue", env))
+                {
+                    std::cout<<" [x] Sent '"<<msg<<"'\n";
+                }
+                else
+                {
+                    std::cout<<" [x] Not sent, publishing is blocked\n";
+                }
                 handler.quit();
             };
 
@@ -15,7 +15,7 @@ int main(void)
                        bool redelivered)
             {
 
-                std::cout <<" [x] Received "<<message.message() << std::endl;
+                std::cout <<" [x] Received "<<message.bodyView() << std::endl;
             });
 
     std::cout << " [*] Waiting for messages. To exit press CTRL-C\n";
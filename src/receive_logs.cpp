@@ -14,7 +14,7 @@ int main(void)
             bool redelivered)
     {
 
-        std::cout <<" [x] "<<message.message() << std::endl;
+        std::cout <<" [x] "<<message.bodyView() << std::endl;
     };
 
     AMQP::QueueCallback callback =
@@ -24,9 +24,9 @@ int main(int argc, const char* argv[])
                bool redelivered)
             {
                 std::cout <<" [x] "
-                          <<message.routingKey()
+                          <<message.routingKeyView()
                           <<":"
-                          <<message.message()
+                          <<message.bodyView()
                           << std::endl;
             };
 
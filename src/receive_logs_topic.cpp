@@ -24,9 +24,9 @@ int main(int argc, const char* argv[])
                bool redelivered)
             {
                 std::cout <<" [x] "
-                          <<message.routingKey()
+                          <<message.routingKeyView()
                           <<":"
-                          <<message.message()
+                          <<message.bodyView()
                           << std::endl;
             };
 
@@ -39,7 +39,7 @@ int main(int argc, const char* argv[])
                 [&](const char* bindingKeys)
                 {
                     std::cout<<bindingKeys<<std::endl;
-                    channel.bindQueue("topic_logs",name, bindingKeys);
+                    channel.bindQueue("topic_logs", name, bindingKeys, AMQP::nowait);
                     channel.consume(name, AMQP::noack).onReceived(receiveMessageCallback);
                 });
 
@@ -19,7 +19,15 @@ int main(int argc, const char* argv[])
         AMQP::Envelope env("30");
         env.setCorrelationID(correlation);
         env.setReplyTo(name);
-        channel.publish("","rpc_queue",env);
+
+        // the server blocks publishing when it runs low on resources, there
+        // is no answer to wait for then
+        if (!channel.publish("","rpc_queue",env))
+        {
+            std::cout<<" [x] Not sent, publishing is blocked"<<std::endl;
+            handler.quit();
+            return;
+        }
         std::cout<<" [x] Requesting fib(30)"<<std::endl;
 
     };
@@ -32,7 +40,7 @@ int main(int argc, const char* argv[])
         if(message.correlationID() != correlation)
             return;
 
-        std::cout<<" [.] Got "<<message.message()<<std::endl;
+        std::cout<<" [.] Got "<<message.bodyView()<<std::endl;
         handler.quit();
     };
 
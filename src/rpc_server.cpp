@@ -25,13 +25,17 @@ int main(void)
     AMQP::Connection connection(&handler, AMQP::Login("guest", "guest"), "/");
 
     AMQP::Channel channel(&connection);
-    channel.setQos(1);
+
+    // tune the prefetch count, with at most 64Mb in unacked messages
+    AMQP::QosController controller(&channel, 1, 100, 64 * 1024 * 1024);
 
     channel.declareQueue("rpc_queue");
-    channel.consume("").onReceived([&channel](const AMQP::Message &message,
+    channel.consume("").onReceived([&channel, &controller](const AMQP::Message &message,
             uint64_t deliveryTag,
             bool redelivered)
     {
+        controller.received(message, deliveryTag);
+
         const auto body = message.message();
         std::cout<<" [.] fib("<<body<<")"<<std::endl;
 
@@ -39,7 +43,7 @@ int main(void)
         env.setCorrelationID(message.correlationID());
 
         channel.publish("", message.replyTo(), env);
-        channel.ack(deliveryTag);
+        controller.ack(deliveryTag);
     });
 
     std::cout << " [x] Awaiting RPC requests" << std::endl;
@@ -0,0 +1,87 @@
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <mutex>
+
+#include "SimplePocoHandler.h"
+
+int fib(int n)
+{
+    switch (n)
+    {
+    case 0:
+        return 0;
+    case 1:
+        return 1;
+    default:
+        return fib(n - 1) + fib(n - 2);
+    }
+}
+
+int main(void)
+{
+    SimplePocoHandler handler("localhost", 5672);
+
+    AMQP::Connection connection(&handler, AMQP::Login("guest", "guest"), "/");
+
+    AMQP::Channel channel(&connection);
+
+    // tune the prefetch count, with at most 64Mb in unacked messages, and
+    // at least enough messages underway to keep all worker threads busy
+    AMQP::QosController controller(&channel, 4, 100, 64 * 1024 * 1024);
+
+    // the handlers run in four threads, so they take turns to write output
+    std::mutex output;
+
+    // the loop thread only reads and parses the requests, they are answered
+    // in four other threads, in whatever order they are done
+    AMQP::Dispatcher dispatcher(&channel, 4, nullptr, [&dispatcher, &output](const AMQP::Message &message,
+            uint64_t,
+            bool)
+    {
+        const auto body = message.message();
+        {
+            std::lock_guard<std::mutex> lock(output);
+            std::cout<<" [.] fib("<<body<<")"<<std::endl;
+        }
+
+        AMQP::Envelope env(std::to_string(fib(std::stoi(body))));
+        env.setCorrelationID(message.correlationID());
+
+        // the answer is published from the loop thread, before the ack
+        dispatcher.publish("", message.replyTo(), env);
+    });
+
+    // the acks and rejects go through the controller, which measures them
+    // (a request that is not a number makes stoi() throw, it is rejected)
+    dispatcher.onAck([&controller](uint64_t deliveryTag, int flags)
+    {
+        return controller.ack(deliveryTag, flags);
+    });
+    dispatcher.onReject([&controller](uint64_t deliveryTag, int flags)
+    {
+        return controller.reject(deliveryTag, flags);
+    });
+
+    // the answers and acks are sent from the loop
+    handler.onTick([&dispatcher]() { dispatcher.flush(); });
+
+    channel.declareQueue("rpc_queue");
+    channel.consume("").onReceived([&controller, &dispatcher](const AMQP::Message &message,
+            uint64_t deliveryTag,
+            bool redelivered)
+    {
+        controller.received(message, deliveryTag);
+
+        // a request that can not be taken over goes back to the queue
+        if (!dispatcher.dispatch(message, deliveryTag, redelivered))
+        {
+            controller.reject(deliveryTag, AMQP::requeue);
+        }
+    });
+
+    std::cout << " [x] Awaiting RPC requests" << std::endl;
+    handler.loop();
+    return 0;
+}
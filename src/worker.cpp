@@ -20,10 +20,10 @@ int main(void)
                        uint64_t deliveryTag,
                        bool redelivered)
             {
-                const auto body = message.message();
+                const auto body = message.bodyView();
                 std::cout<<" [x] Received "<<body<<std::endl;
 
-                size_t count = std::count(body.cbegin(), body.cend(), '.');
+                size_t count = std::count(body.data(), body.data() + body.size(), '.');
                 std::this_thread::sleep_for (std::chrono::seconds(count));
 
                 std::cout<<" [x] Done"<<std::endl;
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <mutex>
+
+#include "SimplePocoHandler.h"
+
+int main(void)
+{
+    SimplePocoHandler handler("localhost", 5672);
+
+    AMQP::Connection connection(&handler, AMQP::Login("guest", "guest"), "/");
+
+    AMQP::Channel channel(&connection);
+
+    // tune the prefetch count, with at most 64Mb in unacked messages, and
+    // at least enough messages underway to keep all worker threads busy
+    AMQP::QosController controller(&channel, 4, 100, 64 * 1024 * 1024);
+
+    // the handlers run in four threads, so they take turns to write output
+    std::mutex output;
+
+    // the tasks do not depend on each other, so they are not dispatched on
+    // a key, but spread over four threads that handle them in parallel
+    AMQP::Dispatcher dispatcher(&channel, 4, nullptr,
+            [&output](const AMQP::Message &message, uint64_t, bool)
+            {
+                const auto body = message.bodyView();
+                {
+                    std::lock_guard<std::mutex> lock(output);
+                    std::cout<<" [x] Received "<<body<<std::endl;
+                }
+
+                size_t count = std::count(body.data(), body.data() + body.size(), '.');
+                std::this_thread::sleep_for (std::chrono::seconds(count));
+
+                std::lock_guard<std::mutex> lock(output);
+                std::cout<<" [x] Done"<<std::endl;
+            });
+
+    // the acks and rejects go through the controller, which measures them
+    dispatcher.onAck([&controller](uint64_t deliveryTag, int flags)
+            {
+                return controller.ack(deliveryTag, flags);
+            });
+    dispatcher.onReject([&controller](uint64_t deliveryTag, int flags)
+            {
+                return controller.reject(deliveryTag, flags);
+            });
+
+    // the acks of the handled messages are sent from the loop
+    handler.onTick([&dispatcher]() { dispatcher.flush(); });
+
+    channel.declareQueue("task_queue", AMQP::durable);
+    channel.consume("task_queue").onReceived(
+            [&controller, &dispatcher](const AMQP::Message &message,
+                       uint64_t deliveryTag,
+                       bool redelivered)
+            {
+                controller.received(message, deliveryTag);
+
+                // a message that can not be taken over goes back to the queue
+                if (!dispatcher.dispatch(message, deliveryTag, redelivered))
+                {
+                    controller.reject(deliveryTag, AMQP::requeue);
+                }
+            });
+
+
+    std::cout << " [*] Waiting for messages. To exit press CTRL-C\n";
+    handler.loop();
+    return 0;
+}